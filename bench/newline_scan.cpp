@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/simd.hpp"
+
+namespace {
+    /// Size of the scanned buffer.
+    constexpr std::size_t BUFFER_SIZE{256UZ * 1024UZ * 1024UZ};
+    /// Number of timed runs per implementation, the fastest one is reported.
+    constexpr std::size_t RUNS{5};
+
+    /// Generates text with lines of 40 to 80 characters, resembling source code.
+    auto generate() -> std::string {
+        std::minstd_rand rng{42};
+        std::uniform_int_distribution<std::size_t> len_dist{40, 80};
+        std::uniform_int_distribution<int> char_dist{' ', '~'};
+
+        std::string data{};
+        data.reserve(BUFFER_SIZE);
+        while (data.size() < BUFFER_SIZE) {
+            const auto len = len_dist(rng);
+            for (auto idx{0UZ}; idx < len; idx += 1) { data.push_back(static_cast<char>(char_dist(rng))); }
+            data.push_back('\n');
+        }
+
+        return data;
+    }
+
+    void find_newlines_naive(const std::string_view data, std::vector<std::size_t>& offsets) {
+        for (auto idx{0UZ}; idx < data.size(); idx += 1) {
+            if (data[idx] == '\n') { offsets.push_back(idx); }
+        }
+    }
+
+    /// Runs fn RUNS times and returns the best throughput in GB/s.
+    template<typename Fn>
+    auto measure(const std::string_view data, std::vector<std::size_t>& offsets, Fn&& fn) -> double {
+        auto best = std::chrono::duration<double>::max();
+        for (auto run{0UZ}; run < RUNS; run += 1) {
+            offsets.clear();
+
+            const auto start = std::chrono::steady_clock::now();
+            fn(data, offsets);
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start));
+        }
+
+        return static_cast<double>(data.size()) / best.count() / 1e9;
+    }
+} // namespace
+
+auto main() -> int {
+    const auto data = generate();
+
+    std::vector<std::size_t> expected{};
+    std::vector<std::size_t> offsets{};
+    expected.reserve(data.size() / 40);
+    offsets.reserve(data.size() / 40);
+
+    const auto naive = measure(data, expected, find_newlines_naive);
+    const auto simd = measure(data, offsets, simd::find_newlines);
+
+    if (offsets != expected) {
+        std::println(stderr, "simd::find_newlines ({}) disagrees with the naive scan", simd::newline_scanner());
+        return EXIT_FAILURE;
+    }
+
+    std::println("scanned {} MiB, {} lines", data.size() / (1024UZ * 1024UZ), expected.size());
+    std::println("naive:  {:6.2f} GB/s", naive);
+    std::println("{:<6}  {:6.2f} GB/s ({:.1f}x)", simd::newline_scanner(), simd, simd / naive);
+
+    return EXIT_SUCCESS;
+}
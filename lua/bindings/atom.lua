@@ -0,0 +1,13 @@
+--- @meta
+
+--- An interned string. Passing an Atom instead of a string as a property key skips interning the string on every call.
+--- Property values are stored as Atoms if they are passed as one or name a face, other strings are copied. Atoms are
+--- never freed, so only intern strings from a small set.
+--- @class Core.Atom
+--- @field name string The interned string.
+Core.Atom = {}
+
+--- Interns a string. Interning the same string always returns an equal Atom.
+--- @param name string
+--- @return Core.Atom
+function Core.Atom(name) end
@@ -8,6 +8,7 @@
 --- @field processes Core.AsyncProcess[] The running AsyncProcesses.
 --- @field workspace Core.Workspace The workspace of the Editor.
 --- @field face_layers string[] The stack of faces getting applied in stack order.
+--- @field max_fps integer The maximum frames rendered per second, requests in between are coalesced. 0 for no limit.
 --- @field cli_args table<string, string> The passed command line arguments.
 local CiniClass = {}
 
@@ -50,6 +51,25 @@ function CiniClass:set_status_message(message, mode, ms, force_viewport) end
 --- Clears the status message in the Mini Buffer.
 function CiniClass:clear_status_message() end
 
+--- Registers a named Face in the global registry.
+--- @param name string
+--- @param face Core.Face
+function CiniClass:register_face(name, face) end
+
+--- Gets a Face from the global registry.
+--- @param name string
+--- @return Core.Face?
+function CiniClass:get_face(name) end
+
+--- Resolves a Face for a DocumentView through the hierarchy of its modes. Resolved Faces are cached per DocumentView.
+--- @param view Core.DocumentView
+--- @param name string
+--- @return Core.Face?
+function CiniClass:resolve_face(view, name) end
+
+--- Outdates the resolved Faces of all DocumentViews.
+function CiniClass:invalidate_faces() end
+
 --- Returns stats meant for debugging.
 --- @return table
 function CiniClass:debug_stats() end
@@ -15,13 +15,30 @@
 --- @field size integer The size in bytes of the data in the Document.
 --- @field lines integer The count of lines in the Document.
 --- @field modified boolean If the Document contains unsaved changes.
+--- @field mapped boolean If the Document references a memory mapped file. Large files are mapped instead of read.
+--- @field loading boolean If the backing file is still being read and indexed in the background. Edits are rejected
+--- meanwhile.
+--- @field saving boolean If the Document is still being written to its backing file in the background.
+--- @field undo_limit integer Maximum memory in bytes used by the undo history, the oldest changes are dropped beyond.
+--- @field revision integer The revision of the data, incremented by every change.
 Core.Document = {}
 
+--- @class Core.Edit
+--- @field start integer Start of the replaced range.
+--- @field stop integer End of the replaced range (exclusive).
+--- @field text string The replacement text.
+
+--- @class Core.Change
+--- @field pos integer Start of the changed range.
+--- @field removed integer Count of removed bytes.
+--- @field inserted integer Count of inserted bytes.
+
 --- Returns all DocumentViews holding this Document.
 --- @return table<integer, Core.DocumentView>
 function Core.Document:views() end
 
---- Writes the contents to the underlying or new path.
+--- Writes the contents to the underlying or new path in the background. "document::after-save" is emitted once the file
+--- was replaced.
 --- @param path string? File path to write to.
 function Core.Document:save(path) end
 
@@ -44,6 +61,18 @@ function Core.Document:clear() end
 --- @param data string
 function Core.Document:replace(start, stop, data) end
 
+--- Creates a Marker at a position that moves with edits of the Document.
+--- @param pos integer
+--- @param gravity? Core.Gravity (defaults to Core.Gravity.Left)
+--- @return Core.Marker
+function Core.Document:create_marker(pos, gravity) end
+
+--- Replaces the ranges from start to stop with text in a single pass. The edits must be sorted and must not overlap.
+--- Instead of insert and remove events, one "document::before-edit" and "document::after-edit" event spanning all
+--- edits is emitted.
+--- @param edits Core.Edit[]
+function Core.Document:apply_edits(edits) end
+
 --- Returns the nth line of the Document.
 --- @param n integer
 --- @return string
@@ -70,6 +99,13 @@ function Core.Document:line_end_byte(nth) end
 --- @return Core.Position
 function Core.Document:position_from_byte(byte) end
 
+--- Returns the changes since a revision in order. Applying them in order to positions of that revision yields positions
+--- of the current revision. Only the latest changes are kept, if they are too old nil is returned and the caller has to
+--- resync completely.
+--- @param revision integer
+--- @return Core.Change[]?
+function Core.Document:changes_since(revision) end
+
 --- Returns matches for a regex pattern over a Document range. Only supply the Regex if you want to use the default
 --- arguments.
 --- @param regex Core.Regex
@@ -78,6 +114,17 @@ function Core.Document:position_from_byte(byte) end
 --- @return Core.RegexMatch[]
 function Core.Document:search(regex, start, stop) end
 
+--- Replaces all matches of a regex pattern in a Document range with a template as a single batch of edits. In the
+--- template, $n and ${n} expand to the nth capture group, ${name} to the named capture group and $$ to a literal $.
+--- Only supply the Regex and template if you want to use the default arguments.
+--- @param regex Core.Regex
+--- @param template string
+--- @param start integer (defaults to 0)
+--- @param stop integer (defaults to the length of the Document)
+--- @return integer? count, string? error The count of replaced matches (0 while the file is loading) or an error for
+--- invalid templates.
+function Core.Document:replace_all(regex, template, start, stop) end
+
 --- Begins a transaction to undo/redo.
 --- @param point integer The current cursor point.
 function Core.Document:begin_transaction(point) end
@@ -94,6 +141,12 @@ function Core.Document:undo() end
 --- @return nil|integer The cursor position or nil if nothing to redo.
 function Core.Document:redo() end
 
+--- @class Core.PropertySpan
+--- @field start integer
+--- @field stop integer
+--- @field value any
+local PropertySpan = {}
+
 --- Add or update text properties on a text range.
 --- The following properties serve a specific function:
 ---     - "keymap": keybinds that are set for the text range.
@@ -101,27 +154,44 @@ function Core.Document:redo() end
 --- The evaluation order of faces is defined in Cini.face_layers
 --- @param start integer
 --- @param stop integer
---- @param key string
+--- @param key string|Core.Atom
 --- @param value any
 function Core.Document:add_text_property(start, stop, key, value) end
 
+--- Add or update text properties on multiple text ranges at once. This is much faster than adding them one by
+--- one, especially if the ranges are sorted and start behind all existing properties of the key. Later ranges replace
+--- earlier ones where they overlap.
+--- @param key string|Core.Atom
+--- @param spans Core.PropertySpan[]
+function Core.Document:add_text_properties(key, spans) end
+
 --- Removes text properties from a text range.
 --- @param start integer
 --- @param stop integer
---- @param key string
+--- @param key string|Core.Atom
 function Core.Document:remove_text_property(start, stop, key) end
 
 --- Removes all (matching) text properties from the Document.
---- @param key? string
+--- @param key? string|Core.Atom
 function Core.Document:clear_text_properties(key) end
 
 --- Merges matching overlapping text properties.
---- @param key string
+--- @param key string|Core.Atom
 function Core.Document:optimize_text_properties(key) end
 
+--- Starts a new generation of matching text properties. Properties that are not added again with the same range
+--- before the generation ends are removed. Recomputing properties this way reuses all unchanged ones instead of
+--- clearing and re-adding them.
+--- @param key string|Core.Atom
+function Core.Document:begin_text_property_generation(key) end
+
+--- Ends the current generation of matching text properties, removing all that were not added again.
+--- @param key string|Core.Atom
+function Core.Document:end_text_property_generation(key) end
+
 --- Returns the matching text property at a point.
 --- @param point integer
---- @param key string
+--- @param key string|Core.Atom
 --- @return any
 function Core.Document:get_text_property(point, key) end
 
@@ -131,6 +201,14 @@ function Core.Document:get_text_property(point, key) end
 function Core.Document:get_text_properties(point) end
 
 --- Returns a list of all text properties with a specific key.
---- @param key string
+--- @param key string|Core.Atom
 --- @return table[]
 function Core.Document:get_all_text_properties(key) end
+
+--- Returns all (matching) text properties overlapping a text range, grouped by key. Only properties in the range are
+--- visited, making this much cheaper than get_all_text_properties for e.g. the visible part of a large Document.
+--- @param start integer
+--- @param stop integer
+--- @param key? string|Core.Atom
+--- @return table<string, Core.PropertySpan[]>
+function Core.Document:get_text_properties_in_range(start, stop, key) end
@@ -37,27 +37,44 @@ function Core.DocumentView:move_cursor(move_func, n) end
 --- The evaluation order of faces is defined in Cini.face_layers
 --- @param start integer
 --- @param stop integer
---- @param key string
+--- @param key string|Core.Atom
 --- @param value any
 function Core.DocumentView:add_view_property(start, stop, key, value) end
 
+--- Add or update view properties on multiple text ranges at once. This is much faster than adding them one by
+--- one, especially if the ranges are sorted and start behind all existing properties of the key. Later ranges replace
+--- earlier ones where they overlap.
+--- @param key string|Core.Atom
+--- @param spans Core.PropertySpan[]
+function Core.DocumentView:add_view_properties(key, spans) end
+
 --- Removes view properties from a text range.
 --- @param start integer
 --- @param stop integer
---- @param key string
+--- @param key string|Core.Atom
 function Core.DocumentView:remove_view_property(start, stop, key) end
 
 --- Removes all (matching) view properties from the Document.
---- @param key? string
+--- @param key? string|Core.Atom
 function Core.DocumentView:clear_view_properties(key) end
 
 --- Merges matching overlapping view properties.
---- @param key string
+--- @param key string|Core.Atom
 function Core.DocumentView:optimize_view_properties(key) end
 
+--- Starts a new generation of matching view properties. Properties that are not added again with the same range
+--- before the generation ends are removed. Recomputing properties this way reuses all unchanged ones instead of
+--- clearing and re-adding them.
+--- @param key string|Core.Atom
+function Core.DocumentView:begin_view_property_generation(key) end
+
+--- Ends the current generation of matching view properties, removing all that were not added again.
+--- @param key string|Core.Atom
+function Core.DocumentView:end_view_property_generation(key) end
+
 --- Returns the matching view property at a point.
 --- @param pos integer
---- @param key string
+--- @param key string|Core.Atom
 --- @return any
 function Core.DocumentView:get_view_property(pos, key) end
 
@@ -67,10 +84,18 @@ function Core.DocumentView:get_view_property(pos, key) end
 function Core.DocumentView:get_view_properties(pos) end
 
 --- Returns a list of all view properties with a specific key.
---- @param key string
+--- @param key string|Core.Atom
 --- @return table<integer, any>
 function Core.DocumentView:get_all_view_properties(key) end
 
+--- Returns all (matching) view properties overlapping a text range, grouped by key. Only properties in the range are
+--- visited, making this much cheaper than get_all_view_properties for e.g. the visible part of a large Document.
+--- @param start integer
+--- @param stop integer
+--- @param key? string|Core.Atom
+--- @return table<string, Core.PropertySpan[]>
+function Core.DocumentView:get_view_properties_in_range(start, stop, key) end
+
 --- Configures the Mode Line.
 --- Callback returns a list of { text="...", face="..." } or { spacer=true }.
 --- @param callback fun(viewport: Core.Viewport): table[]
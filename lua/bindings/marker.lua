@@ -0,0 +1,16 @@
+--- @meta
+
+--- Decides on which side of text inserted at a Marker's position the Marker ends up.
+--- @enum Core.Gravity
+Core.Gravity = {
+    Left = 0,
+    Right = 1,
+}
+
+--- A position in a Document that moves with its edits without any Lua hooks. A Marker inside removed text moves to
+--- the start of the removal. Markers are created by Core.Document:create_marker and are updated as long as they are
+--- referenced.
+--- @class Core.Marker
+--- @field pos integer Byte position in the Document.
+--- @field gravity Core.Gravity Side of text inserted at the position the Marker ends up on.
+Core.Marker = {}
@@ -1,10 +1,6 @@
 --- @class Core.Faces
 local Faces = {}
 
---- Global face registry.
---- @type table<string, Core.Face>
-Faces.faces = {}
-
 function Faces.init()
     Core.Faces = Faces
 end
@@ -13,18 +9,17 @@ end
 --- @param name string
 --- @param face Core.Face
 function Faces.register_face(name, face)
-    Faces.faces[name] = face
+    Cini:register_face(name, face)
 end
 
 --- Retrieves a face by name.
 --- @param name string
 --- @return Core.Face?
 function Faces.get_face(name)
-    return Faces.faces[name]
+    return Cini:get_face(name)
 end
 
---- Resolves a face for a specific Document. This function must never modify text properties. Failure to do so can
---- result in UB and crashes.
+--- Resolves a face for a specific Document.
 ---
 --- Faces are searched in a hierarchy:
 --- 1. DocumentView Minor Mode Override
@@ -32,43 +27,18 @@ end
 --- 3. Document Minor Modes
 --- 4. Document Major Mode
 --- 5. Global Registry
+---
+--- Resolved faces are cached per DocumentView until a face is registered or a mode changes.
 --- @param view Core.DocumentView
 --- @param name string
 --- @return Core.Face?
 function Faces.resolve_face(view, name)
-    local function resolve(mode)
-        if mode and mode.faces and mode.faces[name] then
-            local res = mode.faces[name]
-            return type(res) == "string" and Faces.get_face(res) or res
-        end
-
-        return nil
-    end
-
-    -- 1. DocumentView Minor Mode Override.
-    local override = resolve(Core.Modes.get_minor_mode_override(view))
-    if override then return override end
-
-    -- 2. DocumentView Minor Modes.
-    local view_minor_modes = Core.Modes.get_minor_modes(view)
-    for idx = #view_minor_modes, 1, -1 do
-        local res = resolve(view_minor_modes[idx])
-        if res then return res end
-    end
-
-    -- 3. Document Minor Modes.
-    local doc_minor_modes = Core.Modes.get_minor_modes(view.doc)
-    for idx = #doc_minor_modes, 1, -1 do
-        local res = resolve(doc_minor_modes[idx])
-        if res then return res end
-    end
-
-    -- 4. Document Major Mode.
-    local major_mode = resolve(Core.Modes.get_major_mode(view.doc))
-    if major_mode then return major_mode end
+    return Cini:resolve_face(view, name)
+end
 
-    -- 5. Global Registry.
-    return Faces.get_face(name)
+--- Outdates all cached faces. Must be called after the faces of a mode were modified in place.
+function Faces.invalidate()
+    Cini:invalidate_faces()
 end
 
 return Faces
@@ -32,7 +32,7 @@ end
 ---     - "document::created" | "document::destroyed": fun(Core.Document)
 ---         after a Core.Document was created or destroyed.
 ---     - "document::before-file-load" | "document::after-file-load": fun(Core.Document)
----         before or after a Core.Document read a file from disk.
+---         before a Core.Document starts reading a file from disk, or after the file was read in the background.
 ---     - "document::file-type": fun(Core.Document)
 ---         after a Core.Document was created and the backing filepath has no file extension.
 ---     - "document::file-type-XYZ": fun(Core.Document)
@@ -44,10 +44,14 @@ end
 ---         before or after data is inserted to the Core.Document.
 ---     - "document::before-remove" | "document::after-remove" : fun(Core.Document, start: integer, len: integer)
 ---         before or after data is removed from the Core.Document.
+---     - "document::before-edit": fun(Core.Document, start: integer, len: integer)
+---         before a batch of edits replaces data in the range from start to start + len of the Core.Document.
+---     - "document::after-edit": fun(Core.Document, start: integer, len: integer, new_len: integer)
+---         after a batch of edits replaced data in the range from start to start + len with new_len bytes.
 ---     - "document::before-clear" | "document::after-clear" : fun(Core.Document)
 ---         before or after the Core.Document is cleared.
 ---     - "document::before-save" | "document::after-save": fun(Core.Document)
----         before or after a Core.Document is saved using Core.Document:save.
+---         before a Core.Document is saved using Core.Document:save, or after the file was written in the background.
 ---     - "document::set-major-mode" | "document::unset-major-mode": fun(Core.Document, name: string)
 ---         when a major mode gets set or unset on a Core.Document.
 ---
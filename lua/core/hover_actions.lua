@@ -1,12 +1,15 @@
 --- @class Core.HoverActions
 local HoverActions = {}
 
+-- Hover actions are looked up on every cursor move, skip interning the key each time.
+local hover_action_atom = Core.Atom("hover_action")
+
 function HoverActions.init()
     Core.Hooks.add("cursor::after-move", 10, function(view, pos)
         --- @cast view Core.DocumentView
         --- @cast pos integer
 
-        local action = view:get_view_property(pos, "hover_action")
+        local action = view:get_view_property(pos, hover_action_atom)
 
         if action and type(action) == "function" then
             local ok, err = xpcall(action, debug.traceback, view)
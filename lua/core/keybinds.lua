@@ -9,6 +9,9 @@ Keybinds.pending_map = nil
 --- @type string[]
 Keybinds.pending_keys = {}
 
+-- Keymaps are looked up on every key, skip interning the key each time.
+local keymap_atom = Core.Atom("keymap")
+
 function Keybinds.init()
     Core.Keybinds = Keybinds
 end
@@ -113,7 +116,7 @@ function Keybinds.fetch_keymaps()
     local maps = {}
 
     -- 1. DocumentView View Properties.
-    local view_property_keymap = view:get_view_property(view.cur:point(view), "keymap")
+    local view_property_keymap = view:get_view_property(view.cur:point(view), keymap_atom)
     if view_property_keymap then table.insert(maps, view_property_keymap) end
 
     -- 2. DocumentView Minor Mode Override.
@@ -128,7 +131,7 @@ function Keybinds.fetch_keymaps()
     end
 
     -- 4. Document Text Porperties.
-    local text_property_keymap = view.doc:get_text_property(view.cur:point(view), "keymap")
+    local text_property_keymap = view.doc:get_text_property(view.cur:point(view), keymap_atom)
     if text_property_keymap then table.insert(maps, text_property_keymap) end
 
     -- 5. Document Minor Modes.
@@ -20,6 +20,7 @@ end
 --- @param mode Core.Mode
 function Modes.register_mode(mode)
     Modes.modes[mode.name] = mode
+    Cini:invalidate_faces()
 end
 
 --- Retrieves a mode by name.
@@ -44,6 +45,7 @@ function Modes.set_major_mode(doc, mode)
     if curr_mode then Core.Hooks.run("document::unset-major-mode", doc, curr_mode) end
 
     doc.properties["major_mode"] = mode
+    Cini:invalidate_faces()
 
     Core.Hooks.run("document::set-major-mode", doc, mode)
 end
@@ -77,6 +79,7 @@ function Modes.add_minor_mode(doc, mode)
     table.insert(modes, mode)
 
     doc.properties["minor_modes"] = modes
+    Cini:invalidate_faces()
 end
 
 --- Removes a Minor Mode from a Document or DocumentView.
@@ -96,6 +99,7 @@ function Modes.remove_minor_mode(doc, mode)
     end
 
     doc.properties["minor_modes"] = modes
+    Cini:invalidate_faces()
 end
 
 --- Checks if a Document or DocumentView has a specific Minor Mode.
@@ -125,12 +129,14 @@ end
 --- @param mode string
 function Modes.set_minor_mode_override(view, mode)
     view.properties["minor_mode_override"] = mode
+    Cini:invalidate_faces()
 end
 
 --- Removes the Minor Mode Override from a DocumentView.
 --- @param view Core.DocumentView
 function Modes.remove_minor_mode_override(view)
     view.properties["minor_mode_override"] = nil
+    Cini:invalidate_faces()
 end
 
 --- Resolves a cursor style for a specific DocumentView. This function must never modify text properties. Failure to do
@@ -12,6 +12,13 @@ function Quit.safe_quit()
         return
     end
 
+    for _, doc in ipairs(Cini.documents) do
+        if doc.saving then
+            Cini:set_status_message("Can't quit while documents are being saved", "error_message", 3000, false)
+            return
+        end
+    end
+
     local count = 0
     local name = ""
 
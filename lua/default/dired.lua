@@ -159,6 +159,9 @@ function Dired.refresh(doc, dir)
     local p = io.popen(cmd)
     if not p then return end
 
+    --- @type table<string, Core.PropertySpan[]>
+    local spans = { path = {}, is_dir = {}, face = {} }
+
     local first = true
     for line in p:lines() do
         if not line:match("^total ") then
@@ -181,18 +184,18 @@ function Dired.refresh(doc, dir)
                 local start = doc.size
                 doc:insert(start, string.format("%s%s", first and "" or "\n", line))
 
-                doc:add_text_property(start, doc.size, "path", path)
-                doc:add_text_property(start, doc.size, "is_dir", is_dir)
+                table.insert(spans.path, { start = start, stop = doc.size, value = path })
+                table.insert(spans.is_dir, { start = start, stop = doc.size, value = is_dir })
 
                 start = first and start or (start + 1)
                 local info_stop = start + #prefix
 
-                doc:add_text_property(start, info_stop, "face", "dired.info")
+                table.insert(spans.face, { start = start, stop = info_stop, value = "dired.info" })
 
                 if is_dir then
-                    doc:add_text_property(info_stop, doc.size, "face", "dired.dir")
+                    table.insert(spans.face, { start = info_stop, stop = doc.size, value = "dired.dir" })
                 elseif line:sub(1, 1) == "l" then
-                    doc:add_text_property(info_stop, doc.size, "face", "dired.symlink")
+                    table.insert(spans.face, { start = info_stop, stop = doc.size, value = "dired.symlink" })
                 end
 
                 first = false
@@ -201,6 +204,8 @@ function Dired.refresh(doc, dir)
     end
     p:close()
 
+    for key, key_spans in pairs(spans) do doc:add_text_properties(key, key_spans) end
+
     for _, view in ipairs(doc:views()) do
         view:move_cursor(function(c, v, _) c:_jump_to_beginning_of_file(v) end, 0)
         Dired.update_selection(view)
@@ -82,56 +82,25 @@ function Global.setup()
         doc.properties["loaded"] = false
     end)
 
-    Core.Hooks.add("document::before-insert", 10, function(doc, _, _)
+    -- Cursors are moved along with edits by the Document, only the viewport needs to follow them.
+    Core.Hooks.add("document::after-insert", 10, function(doc, _, _)
         --- @cast doc Core.Document
 
-        for _, view in ipairs(doc:views()) do view.properties["tmp_point"] = view.cur:point(view) end
-    end)
-    Core.Hooks.add("document::before-remove", 10, function(doc, _, _)
-        --- @cast doc Core.Document
-
-        for _, view in ipairs(doc:views()) do view.properties["tmp_point"] = view.cur:point(view) end
+        if Cini.workspace.viewport.view.doc == doc then Cini.workspace.viewport:adjust() end
     end)
-    Core.Hooks.add("document::after-insert", 10, function(doc, start, len)
+    Core.Hooks.add("document::after-remove", 10, function(doc, _, _)
         --- @cast doc Core.Document
-        --- @cast start integer
-        --- @cast len integer
-
-        for _, view in ipairs(doc:views()) do
-            local offset = view.properties["tmp_point"]
-            if offset > start then view.cur:move_to(view, offset + len) end
-            view.properties["tmp_point"] = nil
-        end
 
         if Cini.workspace.viewport.view.doc == doc then Cini.workspace.viewport:adjust() end
     end)
-    Core.Hooks.add("document::after-remove", 10, function(doc, start, len)
+    Core.Hooks.add("document::after-edit", 10, function(doc, _, _, _)
         --- @cast doc Core.Document
-        --- @cast start integer
-        --- @cast len integer
-
-        for _, view in ipairs(doc:views()) do
-            local offset = view.properties["tmp_point"]
-
-            if offset > start then
-                if offset <= start + len then -- The cursor was inside the deleted range.
-                    view.cur:move_to(view, start)
-                else                          -- The cursor was after the deleted range.
-                    view.cur:move_to(view, offset - len)
-                end
-            else
-                view.cur:move_to(view, offset)
-            end
-
-            view.properties["tmp_point"] = nil
-        end
 
         if Cini.workspace.viewport.view.doc == doc then Cini.workspace.viewport:adjust() end
     end)
     Core.Hooks.add("document::after-clear", 10, function(doc)
         --- @cast doc Core.Document
 
-        for _, view in ipairs(doc:views()) do view.cur:move_to(view, 0) end
         if Cini.workspace.viewport.view.doc == doc then Cini.workspace.viewport:adjust() end
     end)
 
@@ -392,10 +361,12 @@ function Global.setup()
             collectgarbage()
 
             local stats = Cini:debug_stats()
-            local msg = ("[Health] Docs: %d (%d tracked) | Views: %d (%d tracked) | Viewports: %d | Processes: %d (%d tracked)")
+            local msg = ("[Health] Docs: %d (%d tracked) | Views: %d (%d tracked) | Viewports: %d | Processes: %d (%d tracked)"
+                .. " | Last Frame: %d B (%d B saved)")
                 :format(
                     stats.document_instances, stats.documents, stats.document_view_instances, stats.document_views,
-                    stats.viewport_instances, stats.process_instances, stats.processes)
+                    stats.viewport_instances, stats.process_instances, stats.processes, stats.frame_bytes,
+                    stats.frame_bytes_saved)
 
             Cini:set_status_message(msg, "info_message", 0, false)
         end
@@ -1,9 +1,7 @@
 local ManPager = {}
 
---- @class ManPager.Style
---- @field start integer
---- @field stop integer
---- @field face Core.Face
+--- @class ManPager.Style: Core.PropertySpan
+--- @field value Core.Face
 
 function ManPager.setup()
     -- Modes.
@@ -68,10 +66,10 @@ function ManPager.setup()
 
                 if ch == '_' then
                     table.insert(styles,
-                        { start = curr_byte, stop = curr_byte + draw_ch_len, face = Core.Face({ underline = true }) })
+                        { start = curr_byte, stop = curr_byte + draw_ch_len, value = Core.Face({ underline = true }) })
                 elseif ch == draw_ch then
                     table.insert(styles,
-                        { start = curr_byte, stop = curr_byte + draw_ch_len, face = Core.Face({ bold = true }) })
+                        { start = curr_byte, stop = curr_byte + draw_ch_len, value = Core.Face({ bold = true }) })
                 end
 
                 table.insert(formatted, draw_ch)
@@ -88,9 +86,7 @@ function ManPager.setup()
         doc:insert(0, table.concat(formatted))
         doc.modified = false
 
-        for _, style in ipairs(styles) do
-            doc:add_text_property(style.start, style.stop, "face", style.face)
-        end
+        doc:add_text_properties("face", styles)
     end)
 
     Core.Hooks.add("document_view::created", 50, function(view)
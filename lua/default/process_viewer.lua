@@ -178,6 +178,9 @@ function ProcessViewer.refresh(doc)
         doc:insert(0, "No active processes.")
         doc:add_text_property(0, doc.size, "face", "document_viewer.background")
     else
+        --- @type Core.PropertySpan[], Core.PropertySpan[]
+        local processes, faces = {}, {}
+
         local first = true
         for _, process in ipairs(Cini.processes) do
             local text = string.format("%s[%s] -> %s", first and "" or "\n", process.command,
@@ -185,14 +188,17 @@ function ProcessViewer.refresh(doc)
 
             local start = doc.size
             doc:insert(start, text)
-            doc:add_text_property(start, doc.size, "process", process)
+            table.insert(processes, { start = start, stop = doc.size, value = process })
 
             start = first and start or (start + 1)
             local stop = start + 1
-            doc:add_text_property(start, stop, "face", "document_viewer.foreground")
+            table.insert(faces, { start = start, stop = stop, value = "document_viewer.foreground" })
 
             first = false
         end
+
+        doc:add_text_properties("process", processes)
+        doc:add_text_properties("face", faces)
     end
 
     doc.modified = false
@@ -68,21 +68,18 @@ function Replace.run(view, pattern, replacement, start, stop)
         return
     end
 
-    local matches = view.doc:search(regex, start, stop)
-    if not matches or #matches == 0 then
-        Cini:set_status_message("No matches found", "info_message", 3000, false)
-        return
-    end
-
     local pos = view.cur:point(view)
     view.doc:begin_transaction(pos)
-    for idx = #matches, 1, -1 do
-        local match = matches[idx]
-        view.doc:replace(match.start, match.stop, replacement)
-    end
+    local count, template_err = view.doc:replace_all(regex, replacement, start, stop)
     view.doc:end_transaction(pos)
 
-    Cini:set_status_message(("Replaced %d occurrences"):format(#matches), "info_message", 3000, false)
+    if not count then
+        Cini:set_status_message(("Replacement error: %s"):format(template_err), "error_message", 3000, false)
+    elseif count == 0 then
+        Cini:set_status_message("No matches found", "info_message", 3000, false)
+    else
+        Cini:set_status_message(("Replaced %d occurrences"):format(count), "info_message", 3000, false)
+    end
 end
 
 return Replace
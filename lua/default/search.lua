@@ -25,6 +25,9 @@ function Search.setup()
     Core.Hooks.add("document::after-remove", 50, function(doc, _, _)
         for _, view in ipairs(doc:views()) do Search.stop(view) end
     end)
+    Core.Hooks.add("document::after-edit", 50, function(doc, _, _, _)
+        for _, view in ipairs(doc:views()) do Search.stop(view) end
+    end)
     Core.Hooks.add("document::after-clear", 50, function(doc)
         for _, view in ipairs(doc:views()) do Search.stop(view) end
     end)
@@ -156,16 +159,20 @@ end
 
 --- @param view Core.DocumentView
 function Search.update(view)
-    view:clear_view_properties("search")
-
     --- @type Search.State?
     local state = view.properties["search"]
-    if not state then return end
+    if not state then
+        view:clear_view_properties("search")
+        return
+    end
 
+    -- Only the faces of the previous and the new current match change, all other matches are reused.
+    view:begin_view_property_generation("search")
     for idx, match in ipairs(state.results) do
         local face = (idx == state.curr_result) and "search.curr_match" or "search.match"
         view:add_view_property(match.start, match.stop, "search", face)
     end
+    view:end_view_property_generation("search")
 
     local active_match = state.results[state.curr_result]
     if active_match then view:move_cursor(function(c, v, _) c:move_to(v, active_match.start) end, 0) end
@@ -75,6 +75,27 @@ function Selection.setup()
             end
         end
     end)
+    Core.Hooks.add("document::after-edit", 50, function(doc, start, len, new_len)
+        --- @cast doc Core.Document
+        --- @cast start integer
+        --- @cast len integer
+        --- @cast new_len integer
+
+        for _, view in ipairs(doc:views()) do
+            --- @type Selection.State?
+            local state = view.properties["selection"]
+            if state then
+                if state.anchor >= start + len then -- Anchor was after the edited range.
+                    state.anchor = state.anchor + new_len - len
+                elseif state.anchor > start then    -- Anchor was inside the edited range.
+                    state.anchor = math.min(state.anchor, start + new_len)
+                end
+                state.anchor_row = doc:position_from_byte(state.anchor).row
+
+                Selection.update(view)
+            end
+        end
+    end)
     Core.Hooks.add("document::after-clear", 50, function(doc)
         --- @cast doc Core.Document
 
@@ -14,11 +14,12 @@ extern char** environ;
 AsyncProcess::AsyncProcess(
     std::string command, std::vector<std::string> args, std::shared_ptr<Document> doc,
     const std::optional<std::size_t> insert_pos)
-    : command_{std::move(command)}, args_{std::move(args)}, doc_{std::move(doc)}, ansi_parser_{doc_},
-      insert_pos_{insert_pos} {
+    : command_{std::move(command)}, args_{std::move(args)}, doc_{std::move(doc)}, ansi_parser_{doc_} {
     ASSERT(!this->command_.empty(), "");
     ASSERT(this->doc_, "");
 
+    if (insert_pos) { this->insert_marker_ = this->doc_->create_marker(*insert_pos, Gravity::LEFT); }
+
     this->libuv_args_.push_back(command_.data());
     for (auto& arg: args_) { this->libuv_args_.push_back(arg.data()); }
     this->libuv_args_.push_back(nullptr);
@@ -100,13 +101,14 @@ void AsyncProcess::on_read(uv_stream_t* stream, const ssize_t nread, const uv_bu
     if (nread > 0) {
         // Insert text directly into the Document. Since some processes output a lot of text, crossing the C++-Lua
         // boundary for every read could lead to noticable slowdowns.
-        self->insert_pos_ = self->ansi_parser_.parse(
-            std::string_view(buf->base, nread), self->insert_pos_.value_or(self->doc_->size()));
+        const auto pos = self->insert_marker_ ? self->insert_marker_->pos_ : self->doc_->size();
+        self->advance_insert_marker(self->ansi_parser_.parse(std::string_view(buf->base, nread), pos));
 
         Editor::instance()->request_render();
     } else if (nread < 0) {
         // Flush any remaining data.
-        self->insert_pos_ = self->ansi_parser_.flush(self->insert_pos_.value_or(self->doc_->size()));
+        const auto pos = self->insert_marker_ ? self->insert_marker_->pos_ : self->doc_->size();
+        self->advance_insert_marker(self->ansi_parser_.flush(pos));
         Editor::instance()->request_render();
 
         uv_close(reinterpret_cast<uv_handle_t*>(stream), AsyncProcess::on_close);
@@ -135,3 +137,12 @@ void AsyncProcess::on_exit(uv_process_t* req, const int64_t status, const int /*
 
     uv_close(reinterpret_cast<uv_handle_t*>(&self->process_), AsyncProcess::on_close);
 }
+
+void AsyncProcess::advance_insert_marker(const std::size_t pos) {
+    // The Marker keeps the position valid if the Document is edited in between reads.
+    if (this->insert_marker_) {
+        this->insert_marker_->pos_ = pos;
+    } else {
+        this->insert_marker_ = this->doc_->create_marker(pos, Gravity::LEFT);
+    }
+}
@@ -8,6 +8,7 @@
 
 #include <uv.h>
 
+#include "types/marker.hpp"
 #include "util/ansi_text_stream.hpp"
 #include "util/instance_tracker.hpp"
 
@@ -29,7 +30,8 @@ private:
     std::vector<std::string> env_strings_{};
     std::vector<char*> libuv_env_{};
 
-    std::optional<std::size_t> insert_pos_;
+    /// Position the output is inserted at, appending to the Document if unset.
+    std::shared_ptr<Marker> insert_marker_{};
 
     uv_process_t process_{};
     uv_process_options_t options_{};
@@ -59,6 +61,9 @@ private:
     static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
     static void on_close(uv_handle_t* handle);
     static void on_exit(uv_process_t* req, int64_t status, int signal);
+
+    /// Continues inserting output at pos.
+    void advance_insert_marker(std::size_t pos);
 };
 
 #endif
@@ -0,0 +1,19 @@
+#include "bindings.hpp"
+
+#include <string_view>
+
+#include <sol/table.hpp>
+
+#include "../types/atom.hpp"
+
+void AtomBinding::init_bridge(sol::table& core) {
+    // clang-format off
+    core.new_usertype<Atom>("Atom",
+        /* Properties. */
+        "name", sol::property([](const Atom& self) -> std::string_view { return self.name(); }),
+
+        /* Functions. */
+        sol::call_constructor, [](const std::string_view name) -> Atom { return Atom{name}; },
+        sol::meta_function::to_string, [](const Atom& self) -> std::string_view { return self.name(); });
+    // clang-format on
+}
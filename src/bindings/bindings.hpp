@@ -7,6 +7,12 @@ public:
     static void init_bridge(sol::table& core);
 };
 
+struct AtomBinding {
+public:
+    /// Sets up the bridge to make this struct's members and methods available in Lua.
+    static void init_bridge(sol::table& core);
+};
+
 struct ClipboardBinding {
 public:
     /// Sets up the bridge to make this space's members and methods available in Lua.
@@ -61,6 +67,12 @@ public:
     static void init_bridge(sol::table& core);
 };
 
+struct MarkerBinding {
+public:
+    /// Sets up the bridge to make this struct's members and methods available in Lua.
+    static void init_bridge(sol::table& core);
+};
+
 struct PositionBinding {
 public:
     /// Sets up the bridge to make this struct's members and methods available in Lua.
@@ -1,10 +1,15 @@
 #include "bindings.hpp"
 
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
 #include "../document.hpp"
 #include "../document_view.hpp"
 #include "../editor.hpp"
 // Include required because document.hpp forward declares Regex.
 #include "../regex.hpp" // IWYU pragma: keep.
+#include "../types/atom.hpp"
 // Include required because document.hpp forward declares RegexMatch.
 #include "../types/regex_match.hpp" // IWYU pragma: keep.
 
@@ -17,8 +22,16 @@ void DocumentBinding::init_bridge(sol::table& core) {
             return self.path_.transform([](const std::filesystem::path& path) -> std::string { return path.string(); });
         }),
         "size", sol::property([](const Document& self) -> std::size_t { return self.data_.size(); }),
-        "lines", sol::property([](const Document& self) -> std::size_t { return self.line_indices_.size(); }),
+        "lines", sol::property([](const Document& self) -> std::size_t { return self.line_count(); }),
         "modified", &Document::modified_,
+        "mapped", sol::property([](const Document& self) -> bool { return self.mapped(); }),
+        "loading", sol::property([](const Document& self) -> bool { return self.loading(); }),
+        "saving", sol::property([](const Document& self) -> bool { return self.saving(); }),
+        "revision", sol::property([](const Document& self) -> std::size_t { return self.revision(); }),
+        "undo_limit", sol::property(
+            [](const Document& self) -> std::size_t { return self.undo_limit(); },
+            [](Document& self, const std::size_t limit) -> void { self.set_undo_limit(limit); }
+        ),
 
         /* Functions. */
         "views", &Document::views,
@@ -27,30 +40,113 @@ void DocumentBinding::init_bridge(sol::table& core) {
         "remove", &Document::remove,
         "clear", &Document::clear,
         "replace", &Document::replace,
+        "create_marker", [](
+            Document& self, const std::size_t pos, const sol::optional<Gravity> gravity
+        ) -> std::shared_ptr<Marker> {
+            return self.create_marker(pos, gravity.value_or(Gravity::LEFT));
+        },
+        "apply_edits", [](Document& self, const sol::table& edits) -> void {
+            std::vector<Edit> res{};
+            res.reserve(edits.size());
+            for (auto idx{1UZ}; idx <= edits.size(); idx += 1) {
+                const sol::table edit = edits[idx];
+                res.push_back(Edit{
+                    .start_ = edit.get<std::size_t>("start"),
+                    .end_ = edit.get<std::size_t>("stop"),
+                    .text_ = edit.get<std::string>("text")});
+            }
+
+            self.apply_edits(std::move(res));
+        },
         "line", &Document::line,
-        "slice", &Document::slice,
+        "slice", [](const Document& self, const std::size_t start, const std::size_t end) -> std::string {
+            return self.slice(start, end);
+        },
         "line_begin_byte", &Document::line_begin_byte,
         "line_end_byte", &Document::line_end_byte,
         "position_from_byte", &Document::position_from_byte,
+        "changes_since", [](const Document& self, const std::size_t revision) -> std::optional<sol::table> {
+            const auto changes = self.changes_since(revision);
+            if (!changes) { return std::nullopt; }
+
+            auto& lua = Editor::instance()->lua_;
+            auto res = lua.create_table(static_cast<int>(changes->size()));
+            for (const auto& change: *changes) {
+                res.add(lua.create_table_with(
+                    "pos", change.pos_, "removed", change.removed_, "inserted", change.inserted_));
+            }
+
+            return res;
+        },
         "search", sol::overload(
             [](const Document& self, const Regex& regex, std::size_t start, std::size_t end)
                 -> std::vector<RegexMatch> { return self.search(regex, start, end); },
             [](const Document& self, const Regex& regex) -> std::vector<RegexMatch> { return self.search(regex); }
         ),
+        "replace_all", sol::overload(
+            [](Document& self, const Regex& regex, const std::string_view tmpl, std::size_t start, std::size_t end)
+                -> std::pair<std::optional<std::size_t>, std::optional<std::string>> {
+                try {
+                    return {self.replace_all(regex, tmpl, start, end), std::nullopt};
+                } catch (const std::runtime_error& err) {
+                    return {std::nullopt, std::string{err.what()}};
+                }
+            },
+            [](Document& self, const Regex& regex, const std::string_view tmpl)
+                -> std::pair<std::optional<std::size_t>, std::optional<std::string>> {
+                try {
+                    return {self.replace_all(regex, tmpl), std::nullopt};
+                } catch (const std::runtime_error& err) {
+                    return {std::nullopt, std::string{err.what()}};
+                }
+            }
+        ),
         "begin_transaction", &Document::begin_transaction,
         "end_transaction", &Document::end_transaction,
         "undo", &Document::undo,
         "redo", &Document::redo,
-        "add_text_property", &Document::add_text_property,
-        "remove_text_property", &Document::remove_text_property,
-        "clear_text_properties", &Document::clear_text_properties,
-        "optimize_text_properties", &Document::optimize_text_properties,
-        "get_text_property", &Document::get_text_property,
+        "add_text_property", [](
+            Document& self, const std::size_t start, const std::size_t end, const AtomKey& key, sol::object value
+        ) -> void {
+            const auto atom = Atom::from(key);
+            self.add_text_property(start, end, atom, PropertyValue{value, Editor::instance()->is_face_layer(atom)});
+        },
+        "add_text_properties", [](Document& self, const AtomKey& key, const sol::table& spans) -> void {
+            const auto atom = Atom::from(key);
+            const auto intern = Editor::instance()->is_face_layer(atom);
+            self.add_text_properties(atom, PropertyMap::from_spans(atom, spans, intern));
+        },
+        "remove_text_property", [](
+            Document& self, const std::size_t start, const std::size_t end, const AtomKey& key
+        ) -> void {
+            self.remove_text_property(start, end, Atom::from(key));
+        },
+        "clear_text_properties", [](Document& self, const sol::optional<AtomKey>& key) -> void {
+            self.clear_text_properties(key ? std::optional{Atom::from(*key)} : std::nullopt);
+        },
+        "optimize_text_properties", [](Document& self, const AtomKey& key) -> void {
+            self.optimize_text_properties(Atom::from(key));
+        },
+        "begin_text_property_generation", [](Document& self, const AtomKey& key) -> void {
+            self.begin_text_property_generation(Atom::from(key));
+        },
+        "end_text_property_generation", [](Document& self, const AtomKey& key) -> void {
+            self.end_text_property_generation(Atom::from(key));
+        },
+        "get_text_property", [](const Document& self, const std::size_t pos, const AtomKey& key) -> sol::object {
+            return self.get_text_property(pos, Atom::from(key), Editor::instance()->lua_);
+        },
         "get_text_properties", [](const Document& self, const std::size_t pos) -> sol::table {
             return self.get_text_properties(pos, Editor::instance()->lua_);
         },
-        "get_all_text_properties", [](const Document& self, const std::string_view key) -> sol::table {
-            return self.get_all_text_properties(key, Editor::instance()->lua_);
+        "get_all_text_properties", [](const Document& self, const AtomKey& key) -> sol::table {
+            return self.get_all_text_properties(Atom::from(key), Editor::instance()->lua_);
+        },
+        "get_text_properties_in_range", [](
+            const Document& self, const std::size_t start, const std::size_t end, const sol::optional<AtomKey>& key
+        ) -> sol::table {
+            return self.get_text_properties_in_range(
+                start, end, key ? std::optional{Atom::from(*key)} : std::nullopt, Editor::instance()->lua_);
         });
     // clang-format on
 }
@@ -1,11 +1,15 @@
 #include "bindings.hpp"
 
+#include <optional>
+#include <utility>
+
 #include <sol/protected_function.hpp>
 
 // Include required because document_view.hpp forward declares Document.
 #include "../document.hpp" // IWYU pragma: keep.
 #include "../document_view.hpp"
 #include "../editor.hpp"
+#include "../types/atom.hpp"
 
 void DocumentViewBinding::init_bridge(sol::table& core) {
     // clang-format off
@@ -24,16 +28,48 @@ void DocumentViewBinding::init_bridge(sol::table& core) {
                 fn(cur, &view, n_steps);
             }, n);
         },
-        "add_view_property", &DocumentView::add_view_property,
-        "remove_view_property", &DocumentView::remove_view_property,
-        "clear_view_properties", &DocumentView::clear_view_properties,
-        "optimize_view_properties", &DocumentView::optimize_view_properties,
-        "get_view_property", &DocumentView::get_view_property,
+        "add_view_property", [](
+            DocumentView& self, const std::size_t start, const std::size_t end, const AtomKey& key, sol::object value
+        ) -> void {
+            const auto atom = Atom::from(key);
+            self.add_view_property(start, end, atom, PropertyValue{value, Editor::instance()->is_face_layer(atom)});
+        },
+        "add_view_properties", [](DocumentView& self, const AtomKey& key, const sol::table& spans) -> void {
+            const auto atom = Atom::from(key);
+            const auto intern = Editor::instance()->is_face_layer(atom);
+            self.add_view_properties(atom, PropertyMap::from_spans(atom, spans, intern));
+        },
+        "remove_view_property", [](
+            DocumentView& self, const std::size_t start, const std::size_t end, const AtomKey& key
+        ) -> void {
+            self.remove_view_property(start, end, Atom::from(key));
+        },
+        "clear_view_properties", [](DocumentView& self, const sol::optional<AtomKey>& key) -> void {
+            self.clear_view_properties(key ? std::optional{Atom::from(*key)} : std::nullopt);
+        },
+        "optimize_view_properties", [](DocumentView& self, const AtomKey& key) -> void {
+            self.optimize_view_properties(Atom::from(key));
+        },
+        "begin_view_property_generation", [](DocumentView& self, const AtomKey& key) -> void {
+            self.begin_view_property_generation(Atom::from(key));
+        },
+        "end_view_property_generation", [](DocumentView& self, const AtomKey& key) -> void {
+            self.end_view_property_generation(Atom::from(key));
+        },
+        "get_view_property", [](const DocumentView& self, const std::size_t pos, const AtomKey& key) -> sol::object {
+            return self.get_view_property(pos, Atom::from(key), Editor::instance()->lua_);
+        },
         "get_view_properties", [](const DocumentView& self, const std::size_t pos) -> sol::table {
             return self.get_view_properties(pos, Editor::instance()->lua_);
         },
-        "get_all_view_properties", [](const DocumentView& self, const std::string_view key) -> sol::table {
-            return self.get_all_view_properties(key, Editor::instance()->lua_);
+        "get_all_view_properties", [](const DocumentView& self, const AtomKey& key) -> sol::table {
+            return self.get_all_view_properties(Atom::from(key), Editor::instance()->lua_);
+        },
+        "get_view_properties_in_range", [](
+            const DocumentView& self, const std::size_t start, const std::size_t end, const sol::optional<AtomKey>& key
+        ) -> sol::table {
+            return self.get_view_properties_in_range(
+                start, end, key ? std::optional{Atom::from(*key)} : std::nullopt, Editor::instance()->lua_);
         },
         "set_mode_line", [](DocumentView& self, const sol::protected_function& callback) -> void {
             self.mode_line_callback_ = callback;
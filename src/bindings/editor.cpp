@@ -1,5 +1,7 @@
 #include "bindings.hpp"
 
+#include <algorithm>
+
 #include <sol/property.hpp>
 
 #include "../async_process.hpp"
@@ -17,6 +19,7 @@ void EditorBinding::init_bridge(sol::state& lua) {
         "processes", sol::readonly(&Editor::processes_),
         "workspace", sol::readonly(&Editor::workspace_),
         "face_layers", &Editor::face_layers_,
+        "max_fps", &Editor::max_fps_,
         "cli_args", sol::readonly(&Editor::cli_args_),
 
         /* Functions. */
@@ -36,6 +39,16 @@ void EditorBinding::init_bridge(sol::state& lua) {
         },
         "set_status_message", &Editor::set_status_message,
         "clear_status_message", [](Editor& self) -> void { self.workspace_.mini_buffer_.clear_status_message(); },
+        "register_face", [](Editor& self, std::string_view name, const Face& face) -> void {
+            self.faces_.register_face(Atom{name}, face);
+        },
+        "get_face", [](Editor& self, std::string_view name) -> std::optional<Face> {
+            return self.faces_.get_face(Atom{name});
+        },
+        "resolve_face", [](Editor& self, DocumentView& view, std::string_view name) -> std::optional<Face> {
+            return self.faces_.resolve(view, Atom{name}, self.lua_);
+        },
+        "invalidate_faces", [](Editor& self) -> void { self.faces_.invalidate(); },
         "debug_stats", [](Editor& self) -> sol::table {
             auto stats = self.lua_.create_table();
 
@@ -48,6 +61,10 @@ void EditorBinding::init_bridge(sol::state& lua) {
             stats["document_views"] = self.document_views_.size();
             stats["processes"] = self.processes_.size();
 
+            const auto& frame = self.display_.last_frame();
+            stats["frame_bytes"] = frame.bytes_;
+            stats["frame_bytes_saved"] = frame.naive_bytes_ - std::min(frame.naive_bytes_, frame.bytes_);
+
             return stats;
         });
     // clang-format on
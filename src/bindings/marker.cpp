@@ -0,0 +1,20 @@
+#include "bindings.hpp"
+
+#include <sol/table.hpp>
+
+#include "../types/marker.hpp"
+
+void MarkerBinding::init_bridge(sol::table& core) {
+    // clang-format off
+    core.new_enum("Gravity",
+        "Left", Gravity::LEFT,
+        "Right", Gravity::RIGHT);
+
+    core.new_usertype<Marker>("Marker",
+        sol::no_constructor,
+
+        /* Properties. */
+        "pos", &Marker::pos_,
+        "gravity", &Marker::gravity_);
+    // clang-format on
+}
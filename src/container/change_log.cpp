@@ -0,0 +1,42 @@
+#include "change_log.hpp"
+
+#include "../util/assert.hpp"
+
+auto ChangeLog::revision() const -> std::size_t { return this->revision_; }
+
+void ChangeLog::record(const std::size_t pos, const std::size_t removed, const std::size_t inserted) {
+    if (removed == 0 && inserted == 0) { return; }
+
+    // The Change leading to revision n is stored at index n - 1 modulo the capacity.
+    const Change change{.pos_ = pos, .removed_ = removed, .inserted_ = inserted};
+    if (this->changes_.size() < ChangeLog::CAPACITY) {
+        this->changes_.push_back(change);
+    } else {
+        this->changes_[this->revision_ % ChangeLog::CAPACITY] = change;
+    }
+
+    this->revision_ += 1;
+}
+
+void ChangeLog::record_edits(const std::vector<Edit>& edits) {
+    // Unsigned wrap-around makes adding negative shifts well defined.
+    auto delta{0UZ};
+    for (const auto& edit: edits) {
+        this->record(edit.start_ + delta, edit.end_ - edit.start_, edit.text_.size());
+        delta += edit.text_.size() - (edit.end_ - edit.start_);
+    }
+}
+
+auto ChangeLog::since(const std::size_t revision) const -> std::optional<std::vector<Change>> {
+    ASSERT(revision <= this->revision_, "");
+
+    if (this->revision_ - revision > this->changes_.size()) { return std::nullopt; }
+
+    std::vector<Change> changes{};
+    changes.reserve(this->revision_ - revision);
+    for (auto idx = revision; idx < this->revision_; idx += 1) {
+        changes.push_back(this->changes_[idx % ChangeLog::CAPACITY]);
+    }
+
+    return changes;
+}
@@ -0,0 +1,44 @@
+#ifndef CHANGE_LOG_HPP_
+#define CHANGE_LOG_HPP_
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "../types/change.hpp"
+#include "../types/edit.hpp"
+
+/// The ChangeLog records the latest Changes of a Document in a ring buffer. Every Change increments the revision of the
+/// Document, consumers remember the revision they last synced to and catch up with all Changes since then at once
+/// instead of observing every single edit.
+struct ChangeLog {
+private:
+    /// Count of recorded Changes, older Changes are overwritten.
+    static constexpr std::size_t CAPACITY{1024};
+
+    std::vector<Change> changes_{};
+    std::size_t revision_{0};
+
+public:
+    ChangeLog() = default;
+
+    ChangeLog(const ChangeLog&) = delete;
+    auto operator=(const ChangeLog&) -> ChangeLog& = delete;
+    ChangeLog(ChangeLog&&) noexcept = default;
+    auto operator=(ChangeLog&&) noexcept -> ChangeLog& = default;
+
+    /// Gets the count of Changes ever recorded.
+    [[nodiscard]]
+    auto revision() const -> std::size_t;
+
+    /// Records replacing removed bytes at pos with inserted bytes.
+    void record(std::size_t pos, std::size_t removed, std::size_t inserted);
+    /// Records applying sorted, non-overlapping edits as one Change per edit, positioned like applying them in order.
+    void record_edits(const std::vector<Edit>& edits);
+
+    /// Gets the Changes after a revision in order, or nothing if they are no longer recorded.
+    [[nodiscard]]
+    auto since(std::size_t revision) const -> std::optional<std::vector<Change>>;
+};
+
+#endif
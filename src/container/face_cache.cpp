@@ -1,27 +1,19 @@
 #include "face_cache.hpp"
-#include <algorithm>
-#include <iterator>
+
+#include <limits>
 
 #include "property_map.hpp"
 
-FaceCache::FaceCache(const std::size_t idx, const std::string& key, const PropertyMap& property_map) {
+FaceCache::FaceCache(const Atom key, const PropertyMap& property_map) {
     auto it = property_map.properties_.find(key);
-    if (it != property_map.properties_.end() && !it->second.empty()) {
-        this->properties_ = &it->second;
-        if (idx == 0) {
-            this->curr_ = this->properties_->begin();
-        } else {
-            this->curr_ = std::ranges::upper_bound(*this->properties_, idx, {}, &Property::start_);
-            if (this->curr_ != this->properties_->begin()) { this->curr_ = std::prev(this->curr_); }
-        }
-    }
+    if (it != property_map.properties_.end() && !it->second.empty()) { this->properties_ = &it->second; }
 }
 
-void FaceCache::update(const std::size_t idx, const std::function<sol::optional<Face>(std::string_view)>& get_face) {
+void FaceCache::update(const std::size_t idx, const std::function<std::optional<Face>(Atom)>& get_face) {
     // Short circuit on existing match.
     if (idx < this->curr_end_) { return; }
 
-    this->face_ = sol::nullopt;
+    this->face_ = std::nullopt;
 
     // No properties for this key exist.
     if (this->properties_ == nullptr) {
@@ -29,27 +21,26 @@ void FaceCache::update(const std::size_t idx, const std::function<sol::optional<
         return;
     }
 
-    while (this->curr_ != this->properties_->end()) {
-        if (this->curr_->end_ < idx || (this->curr_->end_ == idx && this->curr_->start_ != this->curr_->end_)) {
-            this->curr_++;
-            continue;
-        }
+    const auto* const prop = this->properties_->next(idx);
 
-        if (this->curr_->start_ <= idx) { // Inside property.
-            if (this->curr_->value_.is<Face>()) {
-                this->face_ = this->curr_->value_.as<Face>();
-            } else if (this->curr_->value_.get_type() == sol::type::string) {
-                this->face_ = get_face(this->curr_->value_.as<std::string_view>());
-            }
+    // No more Properties left.
+    if (prop == nullptr) {
+        this->curr_end_ = std::numeric_limits<std::size_t>::max();
+        return;
+    }
 
-            this->curr_end_ = this->curr_->end_;
-        } else { // Before property.
-            this->curr_end_ = this->curr_->start_;
+    if (prop->start_ <= idx) { // Inside property.
+        if (const auto* const face = prop->value_.face(); face) {
+            this->face_ = *face;
+        } else if (const auto atom = prop->value_.atom(); atom) {
+            this->face_ = get_face(*atom);
+        } else if (const auto name = prop->value_.string(); name) {
+            // Names set before their key became a face layer.
+            this->face_ = get_face(Atom{*name});
         }
 
-        return;
+        this->curr_end_ = prop->end_;
+    } else { // Before property.
+        this->curr_end_ = prop->start_;
     }
-
-    // No more Properties left.
-    this->curr_end_ = std::numeric_limits<std::size_t>::max();
 }
@@ -1,34 +1,34 @@
 #ifndef FACE_CACHE_HPP_
 #define FACE_CACHE_HPP_
 
-#include <vector>
+#include <functional>
+#include <optional>
 
+#include "../types/atom.hpp"
 #include "../types/face.hpp"
-#include "../types/property.hpp"
 
 struct PropertyMap;
+struct PropertyTree;
 
 /// The FaceCache is a optimiziation data structure to improve rendering performance. It caches the last found Face
-/// and thus minimizes the amount of necessary face resolve calls in Lua, reduzing the number of Lua <-> C++
-/// interaction.
+/// and thus minimizes the amount of necessary face lookups while walking the Properties of a line.
 struct FaceCache {
 public:
     /// Face found after last call to FaceCache::update.
-    sol::optional<Face> face_{};
+    std::optional<Face> face_{};
 
 private:
     /// Properties to scan for Faces.
-    const std::vector<Property>* properties_{nullptr};
-    /// Current found Property with a Face.
-    std::vector<Property>::const_iterator curr_{};
+    const PropertyTree* properties_{nullptr};
+    /// End of the range the current Face is valid for.
     std::size_t curr_end_{0};
 
 public:
-    FaceCache(std::size_t idx, const std::string& key, const PropertyMap& property_map);
+    FaceCache(Atom key, const PropertyMap& property_map);
 
-    /// Updates face_ to the face at the current index. This irreversibly moves the search forward, making it impossible
-    /// to retreive earlier Faces.
-    void update(std::size_t idx, const std::function<sol::optional<Face>(std::string_view)>& get_face);
+    /// Updates face_ to the face at the current index. The Face is only looked up again once idx leaves the range of
+    /// the current one, so idx must only move forward.
+    void update(std::size_t idx, const std::function<std::optional<Face>(Atom)>& get_face);
 };
 
 #endif
@@ -0,0 +1,75 @@
+#include "face_registry.hpp"
+
+#include <sol/state.hpp>
+
+#include "../document.hpp"
+#include "../document_view.hpp"
+
+void FaceRegistry::register_face(const Atom name, const Face& face) {
+    this->faces_.insert_or_assign(name, face);
+    this->invalidate();
+}
+
+auto FaceRegistry::get_face(const Atom name) const -> std::optional<Face> {
+    if (const auto it = this->faces_.find(name); it != this->faces_.end()) { return it->second; }
+
+    return std::nullopt;
+}
+
+void FaceRegistry::invalidate() { this->generation_ += 1; }
+
+auto FaceRegistry::resolve(DocumentView& view, const Atom name, sol::state& lua) -> std::optional<Face> {
+    auto& cache = view.resolved_faces_;
+    if (cache.generation_ != this->generation_) {
+        cache.faces_.clear();
+        cache.generation_ = this->generation_;
+    }
+
+    if (const auto it = cache.faces_.find(name); it != cache.faces_.end()) { return it->second; }
+
+    return cache.faces_.emplace(name, this->lookup(view, name, lua)).first->second;
+}
+
+auto FaceRegistry::lookup(const DocumentView& view, const Atom name, sol::state& lua) const -> std::optional<Face> {
+    const sol::optional<sol::table> modes = lua["Core"]["Modes"]["modes"];
+    if (!modes) { return this->get_face(name); }
+
+    // Looks up the Face in a mode, nothing if the mode does not define it.
+    auto resolve = [&](const sol::object& mode_name) -> std::optional<std::optional<Face>> {
+        if (mode_name.get_type() != sol::type::string) { return std::nullopt; }
+
+        const sol::optional<sol::table> faces = (*modes)[mode_name]["faces"];
+        if (!faces) { return std::nullopt; }
+
+        const sol::object face = (*faces)[name.name()];
+        if (face.is<Face>()) { return std::make_optional(std::optional{face.as<Face>()}); }
+        if (face.get_type() == sol::type::string) {
+            return std::make_optional(this->get_face(Atom{face.as<std::string_view>()}));
+        }
+
+        return std::nullopt;
+    };
+    auto resolve_stack = [&](const sol::table& properties) -> std::optional<std::optional<Face>> {
+        const sol::optional<sol::table> stack = properties["minor_modes"];
+        if (!stack) { return std::nullopt; }
+
+        // Later modes take precedence.
+        for (auto idx = stack->size(); idx > 0; idx -= 1) {
+            if (auto res = resolve(stack->get<sol::object>(idx)); res) { return res; }
+        }
+
+        return std::nullopt;
+    };
+
+    // 1. DocumentView Minor Mode Override.
+    if (auto res = resolve(view.properties_.get<sol::object>("minor_mode_override")); res) { return *res; }
+    // 2. DocumentView Minor Modes.
+    if (auto res = resolve_stack(view.properties_); res) { return *res; }
+    // 3. Document Minor Modes.
+    if (auto res = resolve_stack(view.doc_->properties_); res) { return *res; }
+    // 4. Document Major Mode.
+    if (auto res = resolve(view.doc_->properties_.get<sol::object>("major_mode")); res) { return *res; }
+
+    // 5. Global Registry.
+    return this->get_face(name);
+}
@@ -0,0 +1,58 @@
+#ifndef FACE_REGISTRY_HPP_
+#define FACE_REGISTRY_HPP_
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+
+#include <sol/forward.hpp>
+
+#include "../types/atom.hpp"
+#include "../types/face.hpp"
+
+struct DocumentView;
+
+/// Faces resolved for a DocumentView, valid as long as the FaceRegistry is in the same generation. Resetting it
+/// outdates the Faces of a single DocumentView.
+struct ResolvedFaces {
+public:
+    std::size_t generation_{0};
+    std::unordered_map<Atom, std::optional<Face>> faces_{};
+};
+
+/// The FaceRegistry stores the globally named Faces and resolves Faces for DocumentViews through the hierarchy of their
+/// modes:
+/// 1. DocumentView Minor Mode Override
+/// 2. DocumentView Minor Modes
+/// 3. Document Minor Modes
+/// 4. Document Major Mode
+/// 5. Global Registry
+///
+/// Modes map names to Faces or names of registered Faces. Resolved Faces are cached per DocumentView, rendering only
+/// walks the modes in Lua for names not resolved since the last time a Face was registered or a mode changed.
+struct FaceRegistry {
+private:
+    std::unordered_map<Atom, Face> faces_{};
+    /// Incremented whenever resolved Faces may have changed, outdating all caches.
+    std::size_t generation_{1};
+
+public:
+    /// Registers a named Face.
+    void register_face(Atom name, const Face& face);
+    /// Gets a registered Face.
+    [[nodiscard]]
+    auto get_face(Atom name) const -> std::optional<Face>;
+    /// Outdates all resolved Faces. Must be called whenever modes or the Faces of modes change.
+    void invalidate();
+
+    /// Resolves a Face for a DocumentView.
+    [[nodiscard]]
+    auto resolve(DocumentView& view, Atom name, sol::state& lua) -> std::optional<Face>;
+
+private:
+    /// Resolves a Face by walking the mode hierarchy.
+    [[nodiscard]]
+    auto lookup(const DocumentView& view, Atom name, sol::state& lua) const -> std::optional<Face>;
+};
+
+#endif
@@ -0,0 +1,333 @@
+#include "line_index.hpp"
+
+#include <numeric>
+
+#include "../util/assert.hpp"
+#include "../util/simd.hpp"
+
+LineIndex::LineIndex() { this->clear(); }
+
+auto LineIndex::line_count() const -> std::size_t { return LineIndex::count(this->root_); }
+auto LineIndex::size() const -> std::size_t { return LineIndex::size(this->root_); }
+
+void LineIndex::insert(const std::size_t pos, const std::string_view data) {
+    ASSERT(pos <= this->size(), "");
+
+    if (data.empty()) { return; }
+
+    const auto position = this->position_from_byte(pos);
+
+    std::vector<std::size_t> newlines{};
+    simd::find_newlines(data, newlines);
+
+    if (newlines.empty()) {
+        this->adjust(position.row_, static_cast<std::ptrdiff_t>(data.size()));
+        return;
+    }
+
+    this->rewrite(position.row_, position.row_, [&](std::vector<std::size_t>& lens, const std::size_t idx) -> void {
+        // The remainder of the line is moved to the last inserted line.
+        const auto tail = lens[idx] - position.col_;
+        lens[idx] = position.col_ + newlines.front() + 1;
+
+        std::vector<std::size_t> added{};
+        added.reserve(newlines.size());
+        for (auto jdx{1UZ}; jdx < newlines.size(); jdx += 1) { added.push_back(newlines[jdx] - newlines[jdx - 1]); }
+        added.push_back(data.size() - (newlines.back() + 1) + tail);
+
+        lens.insert(lens.begin() + static_cast<std::ptrdiff_t>(idx + 1), added.begin(), added.end());
+    });
+}
+
+void LineIndex::remove(const std::size_t start, const std::size_t end) {
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->size(), "");
+
+    if (start == end) { return; }
+
+    const auto first = this->position_from_byte(start);
+    const auto last = this->position_from_byte(end);
+
+    if (first.row_ == last.row_) {
+        this->adjust(first.row_, -static_cast<std::ptrdiff_t>(end - start));
+        return;
+    }
+
+    this->rewrite(first.row_, last.row_, [&](std::vector<std::size_t>& lens, const std::size_t idx) -> void {
+        // Join the beginning of the first line with the remainder of the last line.
+        const auto jdx = idx + (last.row_ - first.row_);
+        lens[idx] = first.col_ + (lens[jdx] - last.col_);
+
+        lens.erase(
+            lens.begin() + static_cast<std::ptrdiff_t>(idx + 1), lens.begin() + static_cast<std::ptrdiff_t>(jdx + 1));
+    });
+}
+
+void LineIndex::replace(
+    const std::size_t start, const std::size_t end, const std::vector<std::string_view>& chunks) {
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->size(), "");
+
+    const auto first = this->position_from_byte(start);
+    const auto last = this->position_from_byte(end);
+
+    this->rewrite(first.row_, last.row_, [&](std::vector<std::size_t>& lens, const std::size_t idx) -> void {
+        const auto jdx = idx + (last.row_ - first.row_);
+
+        // Lines are split by the newlines in chunks, the remainder of the last line is appended to the last new line.
+        std::vector<std::size_t> replaced{};
+        std::vector<std::size_t> newlines{};
+        auto len = first.col_;
+        for (const auto chunk: chunks) {
+            newlines.clear();
+            simd::find_newlines(chunk, newlines);
+
+            auto prev{0UZ};
+            for (const auto newline: newlines) {
+                replaced.push_back(len + (newline + 1 - prev));
+                len = 0;
+                prev = newline + 1;
+            }
+            len += chunk.size() - prev;
+        }
+        replaced.push_back(len + (lens[jdx] - last.col_));
+
+        lens.erase(
+            lens.begin() + static_cast<std::ptrdiff_t>(idx), lens.begin() + static_cast<std::ptrdiff_t>(jdx + 1));
+        lens.insert(lens.begin() + static_cast<std::ptrdiff_t>(idx), replaced.begin(), replaced.end());
+    });
+}
+
+void LineIndex::clear() { this->root_ = this->build({0}); }
+
+void LineIndex::append(LineIndex other) {
+    const auto first_len = other.line_end_byte(0);
+    this->adjust(this->line_count() - 1, static_cast<std::ptrdiff_t>(first_len));
+
+    if (other.line_count() == 1) { return; }
+
+    // Drop the joined line from other, its length now belongs to the last line of this index.
+    other.remove(0, first_len);
+    this->root_ = LineIndex::merge(std::move(this->root_), std::move(other.root_));
+}
+
+auto LineIndex::snapshot() const -> LineIndex {
+    LineIndex res{};
+    res.root_ = this->root_;
+    res.rng_ = this->rng_;
+
+    return res;
+}
+
+auto LineIndex::line_begin_byte(const std::size_t nth) const -> std::size_t {
+    ASSERT(nth < this->line_count(), "");
+
+    const auto leaf = this->find_leaf(nth);
+    const auto idx = static_cast<std::ptrdiff_t>(nth - leaf.line_);
+
+    return std::accumulate(leaf.node_->lens_.begin(), leaf.node_->lens_.begin() + idx, leaf.byte_);
+}
+
+auto LineIndex::line_end_byte(const std::size_t nth) const -> std::size_t {
+    ASSERT(nth < this->line_count(), "");
+
+    const auto leaf = this->find_leaf(nth);
+    const auto idx = static_cast<std::ptrdiff_t>(nth - leaf.line_);
+
+    return std::accumulate(leaf.node_->lens_.begin(), leaf.node_->lens_.begin() + idx + 1, leaf.byte_);
+}
+
+auto LineIndex::position_from_byte(const std::size_t byte) const -> Position {
+    ASSERT(byte <= this->size(), "");
+
+    // The end of the text belongs to the last line.
+    if (byte == this->size()) {
+        const auto row = this->line_count() - 1;
+        return Position{.row_ = row, .col_ = byte - this->line_begin_byte(row)};
+    }
+
+    const auto* node = this->root_.get();
+    auto pos = byte;
+    auto row{0UZ};
+    while (true) {
+        const auto left_size = LineIndex::size(node->left_);
+
+        if (pos < left_size) {
+            node = node->left_.get();
+        } else if (pos < left_size + node->len_) {
+            pos -= left_size;
+            row += LineIndex::count(node->left_);
+            break;
+        } else {
+            pos -= left_size + node->len_;
+            row += LineIndex::count(node->left_) + node->lens_.size();
+            node = node->right_.get();
+        }
+    }
+
+    for (const auto len: node->lens_) {
+        if (pos < len) { break; }
+
+        pos -= len;
+        row += 1;
+    }
+
+    return Position{.row_ = row, .col_ = pos};
+}
+
+auto LineIndex::find_leaf(std::size_t nth) const -> Leaf {
+    auto* node = this->root_.get();
+    auto line{0UZ};
+    auto byte{0UZ};
+    while (true) {
+        const auto left_count = LineIndex::count(node->left_);
+
+        if (nth < left_count) {
+            node = node->left_.get();
+        } else if (nth < left_count + node->lens_.size()) {
+            return Leaf{.node_ = node, .line_ = line + left_count, .byte_ = byte + LineIndex::size(node->left_)};
+        } else {
+            nth -= left_count + node->lens_.size();
+            line += left_count + node->lens_.size();
+            byte += LineIndex::size(node->left_) + node->len_;
+            node = node->right_.get();
+        }
+    }
+}
+
+void LineIndex::adjust(std::size_t nth, const std::ptrdiff_t delta) {
+    // Unsigned wrap-around makes adding a negative delta well defined.
+    const auto change = static_cast<std::size_t>(delta);
+
+    auto* ptr = &this->root_;
+    while (true) {
+        auto& node = LineIndex::unshare(*ptr);
+        node.size_ += change;
+
+        const auto left_count = LineIndex::count(node.left_);
+        if (nth < left_count) {
+            ptr = &node.left_;
+        } else if (nth < left_count + node.lens_.size()) {
+            node.lens_[nth - left_count] += change;
+            node.len_ += change;
+            return;
+        } else {
+            nth -= left_count + node.lens_.size();
+            ptr = &node.right_;
+        }
+    }
+}
+
+void LineIndex::rewrite(
+    const std::size_t first, const std::size_t last,
+    const std::function<void(std::vector<std::size_t>&, std::size_t)>& fn) {
+    ASSERT(first <= last, "");
+    ASSERT(last < this->line_count(), "");
+
+    const auto begin = this->find_leaf(first).line_;
+    const auto last_leaf = this->find_leaf(last);
+    const auto end = last_leaf.line_ + last_leaf.node_->lens_.size();
+
+    auto [left, rest] = LineIndex::split(std::move(this->root_), begin);
+    auto [middle, right] = LineIndex::split(std::move(rest), end - begin);
+
+    std::vector<std::size_t> lens{};
+    lens.reserve(end - begin);
+    LineIndex::flatten(middle.get(), lens);
+    fn(lens, first - begin);
+
+    this->root_ = LineIndex::merge(LineIndex::merge(std::move(left), this->build(lens)), std::move(right));
+}
+
+auto LineIndex::build(const std::vector<std::size_t>& lens) -> std::shared_ptr<Node> {
+    std::shared_ptr<Node> root{nullptr};
+
+    // Distribute the lines evenly to avoid leaving behind tiny leaves.
+    const auto leaves = (lens.size() + LineIndex::LEAF_SIZE - 1) / LineIndex::LEAF_SIZE;
+    auto begin = lens.begin();
+    for (auto idx{0UZ}; idx < leaves; idx += 1) {
+        const auto len = static_cast<std::ptrdiff_t>(lens.size() / leaves + (idx < lens.size() % leaves ? 1 : 0));
+
+        auto node = std::make_shared<Node>(Node{
+            .lens_ = std::vector<std::size_t>(begin, begin + len),
+            .len_ = std::accumulate(begin, begin + len, 0UZ),
+            .size_ = 0,
+            .count_ = 0,
+            .priority_ = static_cast<std::uint32_t>(this->rng_())});
+        LineIndex::update(*node);
+
+        root = LineIndex::merge(std::move(root), std::move(node));
+        begin += len;
+    }
+
+    return root;
+}
+
+void LineIndex::flatten(const Node* node, std::vector<std::size_t>& lens) {
+    while (node != nullptr) {
+        LineIndex::flatten(node->left_.get(), lens);
+        lens.insert(lens.end(), node->lens_.begin(), node->lens_.end());
+
+        // Tail iteration into the right subtree.
+        node = node->right_.get();
+    }
+}
+
+auto LineIndex::size(const std::shared_ptr<Node>& node) -> std::size_t { return node ? node->size_ : 0; }
+auto LineIndex::count(const std::shared_ptr<Node>& node) -> std::size_t { return node ? node->count_ : 0; }
+
+void LineIndex::update(Node& node) {
+    node.size_ = LineIndex::size(node.left_) + node.len_ + LineIndex::size(node.right_);
+    node.count_ = LineIndex::count(node.left_) + node.lens_.size() + LineIndex::count(node.right_);
+}
+
+auto LineIndex::unshare(std::shared_ptr<Node>& node) -> Node& {
+    // The copy shares the children, which are thereby unshared when they are modified next.
+    if (node.use_count() > 1) { node = std::make_shared<Node>(*node); }
+
+    return *node;
+}
+
+auto LineIndex::split(std::shared_ptr<Node> node, const std::size_t nth)
+    -> std::pair<std::shared_ptr<Node>, std::shared_ptr<Node>> {
+    if (!node) { return {nullptr, nullptr}; }
+
+    LineIndex::unshare(node);
+
+    const auto left_count = LineIndex::count(node->left_);
+
+    if (nth <= left_count) {
+        auto [left, right] = LineIndex::split(std::move(node->left_), nth);
+        node->left_ = std::move(right);
+        LineIndex::update(*node);
+
+        return {std::move(left), std::move(node)};
+    }
+
+    ASSERT(nth >= left_count + node->lens_.size(), "split must lie on a leaf boundary");
+
+    auto [left, right] = LineIndex::split(std::move(node->right_), nth - left_count - node->lens_.size());
+    node->right_ = std::move(left);
+    LineIndex::update(*node);
+
+    return {std::move(node), std::move(right)};
+}
+
+auto LineIndex::merge(std::shared_ptr<Node> lhs, std::shared_ptr<Node> rhs) -> std::shared_ptr<Node> {
+    if (!lhs) { return rhs; }
+    if (!rhs) { return lhs; }
+
+    if (lhs->priority_ > rhs->priority_) {
+        LineIndex::unshare(lhs);
+        lhs->right_ = LineIndex::merge(std::move(lhs->right_), std::move(rhs));
+        LineIndex::update(*lhs);
+
+        return lhs;
+    }
+
+    LineIndex::unshare(rhs);
+    rhs->left_ = LineIndex::merge(std::move(lhs), std::move(rhs->left_));
+    LineIndex::update(*rhs);
+
+    return rhs;
+}
@@ -0,0 +1,135 @@
+#ifndef LINE_INDEX_HPP_
+#define LINE_INDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "../types/position.hpp"
+
+/// The LineIndex maps between byte offsets and lines of a text. It stores the length of every line (including its
+/// newline character) in leaves of a randomized balanced tree (treap) ordered by line, augmented with the byte and line
+/// count of every subtree.
+///
+/// Since no absolute offsets are stored, edits never need to shift later lines, making all operations O(log n) in the
+/// number of lines (plus the length of inserted data).
+///
+/// A LineIndex always contains at least one (possibly empty) line.
+///
+/// Like the PieceTable, nodes are shared with snapshots of the index and copied before being modified if they are
+/// shared.
+struct LineIndex {
+private:
+    /// Targeted number of lines per leaf.
+    static constexpr std::size_t LEAF_SIZE{128};
+
+    /// A leaf holds the lengths of consecutive lines.
+    struct Node {
+    public:
+        std::vector<std::size_t> lens_;
+        /// Total length of all lines in this leaf.
+        std::size_t len_;
+        /// Total length of all lines in this subtree.
+        std::size_t size_;
+        /// Total count of lines in this subtree.
+        std::size_t count_;
+        std::uint32_t priority_;
+
+        std::shared_ptr<Node> left_{nullptr};
+        std::shared_ptr<Node> right_{nullptr};
+    };
+
+    /// Location of a leaf in the tree.
+    struct Leaf {
+    public:
+        Node* node_;
+        /// Index of the first line of the leaf.
+        std::size_t line_;
+        /// Byte the first line of the leaf begins at.
+        std::size_t byte_;
+    };
+
+private:
+    std::shared_ptr<Node> root_{nullptr};
+
+    std::minstd_rand rng_{};
+
+public:
+    LineIndex();
+
+    LineIndex(const LineIndex&) = delete;
+    auto operator=(const LineIndex&) -> LineIndex& = delete;
+    LineIndex(LineIndex&&) noexcept = default;
+    auto operator=(LineIndex&&) noexcept -> LineIndex& = default;
+
+    /// Gets the number of lines.
+    [[nodiscard]]
+    auto line_count() const -> std::size_t;
+    /// Gets the size of the indexed text.
+    [[nodiscard]]
+    auto size() const -> std::size_t;
+
+    /// Updates the index after data was inserted at pos.
+    void insert(std::size_t pos, std::string_view data);
+    /// Updates the index after data from start to end was removed.
+    void remove(std::size_t start, std::size_t end);
+    /// Updates the index after data from start to end was replaced by the concatenation of chunks.
+    void replace(std::size_t start, std::size_t end, const std::vector<std::string_view>& chunks);
+    /// Resets the index to a single empty line.
+    void clear();
+    /// Appends the lines of other, joining its first line with the last line of this index.
+    void append(LineIndex other);
+
+    /// Creates an index sharing all nodes with this index in O(1). Edits of either index are not visible in the other
+    /// one.
+    [[nodiscard]]
+    auto snapshot() const -> LineIndex;
+
+    /// Gets the byte beginning the nth line.
+    [[nodiscard]]
+    auto line_begin_byte(std::size_t nth) const -> std::size_t;
+    /// Gets the byte one after the end of the nth line. This includes the newline character.
+    [[nodiscard]]
+    auto line_end_byte(std::size_t nth) const -> std::size_t;
+    /// Gets the position struct from a byte offset.
+    [[nodiscard]]
+    auto position_from_byte(std::size_t byte) const -> Position;
+
+private:
+    /// Finds the leaf containing the nth line.
+    [[nodiscard]]
+    auto find_leaf(std::size_t nth) const -> Leaf;
+    /// Adds delta to the length of the nth line.
+    void adjust(std::size_t nth, std::ptrdiff_t delta);
+    /// Replaces the leaves containing the lines first to last with leaves built from the line lengths after fn
+    /// modified them. fn receives the flattened line lengths and the index of the first line in them.
+    void rewrite(
+        std::size_t first, std::size_t last, const std::function<void(std::vector<std::size_t>&, std::size_t)>& fn);
+
+    /// Builds a tree of evenly filled leaves.
+    [[nodiscard]]
+    auto build(const std::vector<std::size_t>& lens) -> std::shared_ptr<Node>;
+    /// Appends all line lengths of the subtree to lens.
+    static void flatten(const Node* node, std::vector<std::size_t>& lens);
+
+    [[nodiscard]]
+    static auto size(const std::shared_ptr<Node>& node) -> std::size_t;
+    [[nodiscard]]
+    static auto count(const std::shared_ptr<Node>& node) -> std::size_t;
+    static void update(Node& node);
+    /// Copies the node if it is shared, returning the node that may be modified.
+    static auto unshare(std::shared_ptr<Node>& node) -> Node&;
+    /// Splits the tree into the first nth lines and the rest. The split must lie on a leaf boundary.
+    [[nodiscard]]
+    static auto split(std::shared_ptr<Node> node, std::size_t nth)
+        -> std::pair<std::shared_ptr<Node>, std::shared_ptr<Node>>;
+    /// Merges two trees, all lines of lhs preceding all lines of rhs.
+    [[nodiscard]]
+    static auto merge(std::shared_ptr<Node> lhs, std::shared_ptr<Node> rhs) -> std::shared_ptr<Node>;
+};
+
+#endif
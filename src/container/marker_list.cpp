@@ -0,0 +1,53 @@
+#include "marker_list.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+auto MarkerList::create(const std::size_t pos, const Gravity gravity) -> std::shared_ptr<Marker> {
+    auto marker = std::make_shared<Marker>(Marker{.pos_ = pos, .gravity_ = gravity});
+    this->markers_.push_back(marker);
+
+    return marker;
+}
+
+void MarkerList::update_on_insert(const std::size_t pos, const std::size_t len) {
+    if (len == 0) { return; }
+
+    this->for_each([&](Marker& marker) -> void { marker.update_on_insert(pos, len); });
+}
+
+void MarkerList::update_on_remove(const std::size_t start, const std::size_t end) {
+    if (start == end) { return; }
+
+    this->for_each([&](Marker& marker) -> void { marker.update_on_remove(start, end); });
+}
+
+void MarkerList::update_on_edits(const std::vector<Edit>& edits) {
+    if (edits.empty()) { return; }
+
+    // Shift of positions behind the first n edits, wrapping around for negative shifts.
+    std::vector<std::size_t> deltas{};
+    deltas.reserve(edits.size() + 1);
+    deltas.push_back(0);
+    for (const auto& edit: edits) { deltas.push_back(deltas.back() + edit.text_.size() - (edit.end_ - edit.start_)); }
+
+    this->for_each([&](Marker& marker) -> void {
+        // Edits ending before the Marker only shift it, only the few edits reaching it need to be applied.
+        const auto first = std::ranges::lower_bound(edits, marker.pos_, {}, &Edit::end_);
+        auto idx = static_cast<std::size_t>(first - edits.begin());
+        marker.pos_ += deltas[idx];
+
+        for (; idx < edits.size(); idx += 1) {
+            const auto& edit = edits[idx];
+            const auto start = edit.start_ + deltas[idx];
+            if (start > marker.pos_) { break; }
+
+            marker.update_on_remove(start, start + (edit.end_ - edit.start_));
+            marker.update_on_insert(start, edit.text_.size());
+        }
+    });
+}
+
+void MarkerList::clear() {
+    this->for_each([](Marker& marker) -> void { marker.pos_ = 0; });
+}
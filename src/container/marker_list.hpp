@@ -0,0 +1,52 @@
+#ifndef MARKER_LIST_HPP_
+#define MARKER_LIST_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "../types/edit.hpp"
+#include "../types/marker.hpp"
+
+/// The MarkerList keeps the Markers of a Document in sync with its edits. Markers are only weakly referenced, once
+/// their last owner releases them they are dropped on the next update.
+struct MarkerList {
+private:
+    std::vector<std::weak_ptr<Marker>> markers_{};
+
+public:
+    MarkerList() = default;
+
+    MarkerList(const MarkerList&) = delete;
+    auto operator=(const MarkerList&) -> MarkerList& = delete;
+    MarkerList(MarkerList&&) noexcept = default;
+    auto operator=(MarkerList&&) noexcept -> MarkerList& = default;
+
+    /// Creates a Marker that is kept in sync.
+    [[nodiscard]]
+    auto create(std::size_t pos, Gravity gravity) -> std::shared_ptr<Marker>;
+
+    /// Updates Marker positions after insertion.
+    void update_on_insert(std::size_t pos, std::size_t len);
+    /// Updates Marker positions after removal.
+    void update_on_remove(std::size_t start, std::size_t end);
+    /// Updates Marker positions after applying sorted, non-overlapping edits. The result equals removing and inserting
+    /// the text of every edit in order.
+    void update_on_edits(const std::vector<Edit>& edits);
+    /// Moves all Markers to the beginning.
+    void clear();
+
+private:
+    /// Calls fn with every live Marker, dropping released ones.
+    template<typename Fn>
+    void for_each(Fn&& fn) {
+        std::erase_if(this->markers_, [&](const std::weak_ptr<Marker>& weak) -> bool {
+            const auto marker = weak.lock();
+            if (!marker) { return true; }
+
+            fn(*marker);
+            return false;
+        });
+    }
+};
+
+#endif
@@ -19,6 +19,8 @@ MiniBuffer::MiniBuffer(const std::size_t width, const std::size_t height, sol::s
 // NOLINTBEGIN(readability-make-member-function-const)
 void MiniBuffer::set_status_message(const std::string_view message, const std::string_view mode) {
     this->viewport_->view_->properties_["minor_mode_override"] = mode;
+    // Only the Faces of the Mini Buffer change, other views keep their resolved Faces.
+    this->viewport_->view_->resolved_faces_ = {};
 
     this->viewport_->view_->reset_cursor();
     this->viewport_->adjust_viewport();
@@ -34,5 +36,6 @@ void MiniBuffer::clear_status_message() {
 
     this->viewport_->view_->doc_->clear();
     this->viewport_->view_->properties_["minor_mode_override"] = nullptr;
+    this->viewport_->view_->resolved_faces_ = {};
 }
 // NOLINTEND(readability-make-member-function-const)
@@ -0,0 +1,259 @@
+#include "piece_table.hpp"
+
+#include <cstring>
+
+#include "../util/assert.hpp"
+
+auto PieceTable::size() const -> std::size_t { return PieceTable::size(this->root_); }
+auto PieceTable::empty() const -> bool { return this->root_ == nullptr; }
+auto PieceTable::has_externals() const -> bool { return !this->externals_.empty(); }
+
+void PieceTable::insert(const std::size_t pos, const std::string_view data) {
+    ASSERT(pos <= this->size(), "");
+
+    if (data.empty()) { return; }
+
+    const auto* const ptr = this->append(data);
+    auto [left, right] = this->split(std::move(this->root_), pos);
+
+    // Consecutive insertions (e.g. typing) land directly behind the previous piece in the buffer, extend it instead of
+    // creating a new piece.
+    const auto* last = left.get();
+    while (last != nullptr && last->right_ != nullptr) { last = last->right_.get(); }
+
+    if (last != nullptr && ptr != this->blocks_.back().get() && last->data_ + last->len_ == ptr) {
+        for (auto* node = &left; *node != nullptr; node = &(*node)->right_) {
+            auto& curr = PieceTable::unshare(*node);
+            curr.size_ += data.size();
+            if (curr.right_ == nullptr) { curr.len_ += data.size(); }
+        }
+
+        this->root_ = PieceTable::merge(std::move(left), std::move(right));
+    } else {
+        this->root_ = PieceTable::merge(
+            PieceTable::merge(std::move(left), this->make_node(ptr, data.size())), std::move(right));
+    }
+}
+
+void PieceTable::insert_external(
+    const std::size_t pos, const std::string_view data, std::shared_ptr<const void> owner) {
+    ASSERT(pos <= this->size(), "");
+
+    if (data.empty()) { return; }
+
+    this->externals_.push_back(std::move(owner));
+
+    auto [left, right] = this->split(std::move(this->root_), pos);
+    this->root_ = PieceTable::merge(
+        PieceTable::merge(std::move(left), this->make_node(data.data(), data.size())), std::move(right));
+}
+
+void PieceTable::remove(const std::size_t start, const std::size_t end) {
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->size(), "");
+
+    if (start == end) { return; }
+
+    auto [rest, right] = this->split(std::move(this->root_), end);
+    auto [left, _] = this->split(std::move(rest), start);
+
+    this->root_ = PieceTable::merge(std::move(left), std::move(right));
+}
+
+void PieceTable::apply_edits(const std::vector<Edit>& edits) {
+    if (edits.empty()) { return; }
+
+    const auto start = edits.front().start_;
+    const auto end = edits.back().end_;
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->size(), "");
+
+    auto [rest, right] = this->split(std::move(this->root_), end);
+    auto [left, middle] = this->split(std::move(rest), start);
+
+    std::shared_ptr<Node> replaced{nullptr};
+    auto push = [&](const std::string_view chunk) -> void {
+        replaced = PieceTable::merge(std::move(replaced), this->make_node(chunk.data(), chunk.size()));
+    };
+
+    auto pos = start;
+    for (const auto& edit: edits) {
+        ASSERT(pos <= edit.start_ && edit.start_ <= edit.end_, "edits must be sorted and must not overlap");
+
+        // Unchanged data between edits keeps referencing the existing buffers.
+        if (pos < edit.start_) { PieceTable::for_each_chunk(middle.get(), start, pos, edit.start_, push); }
+        if (!edit.text_.empty()) { push(std::string_view{this->append(edit.text_), edit.text_.size()}); }
+
+        pos = edit.end_;
+    }
+
+    this->root_ = PieceTable::merge(PieceTable::merge(std::move(left), std::move(replaced)), std::move(right));
+}
+
+void PieceTable::clear() {
+    this->root_.reset();
+    this->blocks_.clear();
+    this->tail_ = nullptr;
+    this->tail_free_ = 0;
+    this->externals_.clear();
+}
+
+auto PieceTable::snapshot() const -> PieceTable {
+    // The snapshot gets no tail block, it never writes into blocks shared with this table.
+    PieceTable res{};
+    res.root_ = this->root_;
+    res.blocks_ = this->blocks_;
+    res.externals_ = this->externals_;
+    res.rng_ = this->rng_;
+
+    return res;
+}
+
+auto PieceTable::at(std::size_t pos) const -> char {
+    ASSERT(pos < this->size(), "");
+
+    const auto* node = this->root_.get();
+    while (true) {
+        const auto left_size = PieceTable::size(node->left_);
+
+        if (pos < left_size) {
+            node = node->left_.get();
+        } else if (pos < left_size + node->len_) {
+            return node->data_[pos - left_size];
+        } else {
+            pos -= left_size + node->len_;
+            node = node->right_.get();
+        }
+    }
+}
+
+auto PieceTable::contiguous(const std::size_t start, const std::size_t end) const -> std::optional<std::string_view> {
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->size(), "");
+
+    if (start == end) { return std::string_view{}; }
+
+    // Find the piece containing start.
+    const auto* node = this->root_.get();
+    auto pos = start;
+    while (true) {
+        const auto left_size = PieceTable::size(node->left_);
+
+        if (pos < left_size) {
+            node = node->left_.get();
+        } else if (pos < left_size + node->len_) {
+            pos -= left_size;
+            break;
+        } else {
+            pos -= left_size + node->len_;
+            node = node->right_.get();
+        }
+    }
+
+    if (pos + (end - start) > node->len_) { return std::nullopt; }
+    return std::string_view{node->data_ + pos, end - start};
+}
+
+auto PieceTable::copy(const std::size_t start, const std::size_t end) const -> std::string {
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->size(), "");
+
+    std::string res{};
+    res.reserve(end - start);
+    this->for_each_chunk(start, end, [&](const std::string_view chunk) -> void { res.append(chunk); });
+
+    return res;
+}
+
+auto PieceTable::allocate(const std::size_t len) -> char* {
+    if (len > this->tail_free_) {
+        const auto block_len = std::max(len, PieceTable::BLOCK_SIZE);
+        // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+        this->tail_ = this->blocks_.emplace_back(std::make_shared_for_overwrite<char[]>(block_len)).get();
+        this->tail_free_ = block_len;
+    }
+
+    auto* const ptr = this->tail_;
+    this->tail_ += len;
+    this->tail_free_ -= len;
+
+    return ptr;
+}
+
+auto PieceTable::append(const std::string_view data) -> const char* {
+    auto* const ptr = this->allocate(data.size());
+    std::memcpy(ptr, data.data(), data.size());
+
+    return ptr;
+}
+
+auto PieceTable::make_node(const char* data, const std::size_t len) -> std::shared_ptr<Node> {
+    return std::make_shared<Node>(
+        Node{.data_ = data, .len_ = len, .size_ = len, .priority_ = static_cast<std::uint32_t>(this->rng_())});
+}
+
+auto PieceTable::size(const std::shared_ptr<Node>& node) -> std::size_t { return node ? node->size_ : 0; }
+
+void PieceTable::update(Node& node) {
+    node.size_ = PieceTable::size(node.left_) + node.len_ + PieceTable::size(node.right_);
+}
+
+auto PieceTable::unshare(std::shared_ptr<Node>& node) -> Node& {
+    // The copy shares the children, which are thereby unshared when they are modified next.
+    if (node.use_count() > 1) { node = std::make_shared<Node>(*node); }
+
+    return *node;
+}
+
+auto PieceTable::split(std::shared_ptr<Node> node, const std::size_t pos)
+    -> std::pair<std::shared_ptr<Node>, std::shared_ptr<Node>> {
+    if (!node) { return {nullptr, nullptr}; }
+
+    PieceTable::unshare(node);
+
+    const auto left_size = PieceTable::size(node->left_);
+
+    if (pos <= left_size) {
+        auto [left, right] = this->split(std::move(node->left_), pos);
+        node->left_ = std::move(right);
+        PieceTable::update(*node);
+
+        return {std::move(left), std::move(node)};
+    }
+
+    if (pos >= left_size + node->len_) {
+        auto [left, right] = this->split(std::move(node->right_), pos - left_size - node->len_);
+        node->right_ = std::move(left);
+        PieceTable::update(*node);
+
+        return {std::move(node), std::move(right)};
+    }
+
+    // The split point lies inside this piece, cut it in two.
+    const auto offset = pos - left_size;
+    auto right =
+        PieceTable::merge(this->make_node(node->data_ + offset, node->len_ - offset), std::move(node->right_));
+    node->len_ = offset;
+    PieceTable::update(*node);
+
+    return {std::move(node), std::move(right)};
+}
+
+auto PieceTable::merge(std::shared_ptr<Node> lhs, std::shared_ptr<Node> rhs) -> std::shared_ptr<Node> {
+    if (!lhs) { return rhs; }
+    if (!rhs) { return lhs; }
+
+    if (lhs->priority_ > rhs->priority_) {
+        PieceTable::unshare(lhs);
+        lhs->right_ = PieceTable::merge(std::move(lhs->right_), std::move(rhs));
+        PieceTable::update(*lhs);
+
+        return lhs;
+    }
+
+    PieceTable::unshare(rhs);
+    rhs->left_ = PieceTable::merge(std::move(lhs), std::move(rhs->left_));
+    PieceTable::update(*rhs);
+
+    return rhs;
+}
@@ -0,0 +1,152 @@
+#ifndef PIECE_TABLE_HPP_
+#define PIECE_TABLE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../types/edit.hpp"
+
+/// The PieceTable stores text as a sequence of pieces referencing append-only buffers. The pieces are kept in a
+/// randomized balanced tree (treap) ordered by their position in the text, making insertions and removals O(log n)
+/// independent of the size of the text.
+///
+/// Since the text is not stored contiguously, a range is only available as a single view if it lies within one piece
+/// (see PieceTable::contiguous). Consumers that only need to read the data should prefer PieceTable::for_each_chunk.
+///
+/// Pieces may also reference external read-only memory (e.g. a mapped file). External memory is never written to,
+/// edits only create new pieces in the append-only buffers.
+///
+/// Nodes and buffers are shared with snapshots of the table. Nodes are copied before being modified if they are shared
+/// (copy-on-write), so a snapshot stays unchanged and can be read on another thread while the table is edited.
+struct PieceTable {
+private:
+    /// Size of newly allocated buffer blocks. Larger insertions get their own block.
+    static constexpr std::size_t BLOCK_SIZE{64UZ * 1024UZ};
+
+    /// A piece references a contiguous range of bytes in one of the buffers.
+    struct Node {
+    public:
+        const char* data_;
+        std::size_t len_;
+        /// Total length of all pieces in this subtree.
+        std::size_t size_;
+        std::uint32_t priority_;
+
+        std::shared_ptr<Node> left_{nullptr};
+        std::shared_ptr<Node> right_{nullptr};
+    };
+
+private:
+    std::shared_ptr<Node> root_{nullptr};
+
+    /// Append-only storage blocks pieces point into. Blocks are never moved or freed until the table is cleared.
+    std::vector<std::shared_ptr<char[]>> blocks_{}; // NOLINT(modernize-avoid-c-arrays)
+    /// Next free byte in the last block.
+    char* tail_{nullptr};
+    /// Remaining free bytes in the last block.
+    std::size_t tail_free_{0};
+    /// Owners of external memory pieces point into. They are kept alive until the table is cleared.
+    std::vector<std::shared_ptr<const void>> externals_{};
+
+    std::minstd_rand rng_{};
+
+public:
+    PieceTable() = default;
+
+    PieceTable(const PieceTable&) = delete;
+    auto operator=(const PieceTable&) -> PieceTable& = delete;
+    PieceTable(PieceTable&&) noexcept = default;
+    auto operator=(PieceTable&&) noexcept -> PieceTable& = default;
+
+    /// Gets the size of the text.
+    [[nodiscard]]
+    auto size() const -> std::size_t;
+    [[nodiscard]]
+    auto empty() const -> bool;
+    /// Checks if any pieces reference external memory.
+    [[nodiscard]]
+    auto has_externals() const -> bool;
+
+    /// Inserts data at pos.
+    void insert(std::size_t pos, std::string_view data);
+    /// Inserts data at pos without copying it. data must stay valid as long as owner is alive.
+    void insert_external(std::size_t pos, std::string_view data, std::shared_ptr<const void> owner);
+    /// Removes data from start to end.
+    void remove(std::size_t start, std::size_t end);
+    /// Applies sorted, non-overlapping edits. Only the pieces between the first and last edit are rebuilt, unchanged
+    /// data in between is referenced instead of copied.
+    void apply_edits(const std::vector<Edit>& edits);
+    /// Removes all data and frees all buffers and external memory.
+    void clear();
+
+    /// Creates a table sharing all data with this table in O(1) (plus the count of buffer blocks). Edits of either
+    /// table are not visible in the other one.
+    [[nodiscard]]
+    auto snapshot() const -> PieceTable;
+
+    /// Gets the byte at pos.
+    [[nodiscard]]
+    auto at(std::size_t pos) const -> char;
+    /// Gets a view of the data from start to end if it is stored contiguously.
+    [[nodiscard]]
+    auto contiguous(std::size_t start, std::size_t end) const -> std::optional<std::string_view>;
+    /// Copies the data from start to end.
+    [[nodiscard]]
+    auto copy(std::size_t start, std::size_t end) const -> std::string;
+
+    /// Calls fn with every contiguous chunk of data from start to end in order.
+    template<typename Fn>
+    void for_each_chunk(const std::size_t start, const std::size_t end, Fn&& fn) const {
+        if (start < end) { PieceTable::for_each_chunk(this->root_.get(), 0, start, end, fn); }
+    }
+
+private:
+    /// Reserves len bytes in the buffers and returns a pointer to them.
+    auto allocate(std::size_t len) -> char*;
+    /// Copies data into the buffers and returns a pointer to the copied bytes.
+    auto append(std::string_view data) -> const char*;
+
+    auto make_node(const char* data, std::size_t len) -> std::shared_ptr<Node>;
+
+    [[nodiscard]]
+    static auto size(const std::shared_ptr<Node>& node) -> std::size_t;
+    static void update(Node& node);
+    /// Copies the node if it is shared, returning the node that may be modified.
+    static auto unshare(std::shared_ptr<Node>& node) -> Node&;
+    /// Splits the tree into the first pos bytes and the rest, splitting pieces if necessary.
+    [[nodiscard]]
+    auto split(std::shared_ptr<Node> node, std::size_t pos) -> std::pair<std::shared_ptr<Node>, std::shared_ptr<Node>>;
+    /// Merges two trees, all pieces of lhs preceding all pieces of rhs.
+    [[nodiscard]]
+    static auto merge(std::shared_ptr<Node> lhs, std::shared_ptr<Node> rhs) -> std::shared_ptr<Node>;
+
+    template<typename Fn>
+    static void for_each_chunk(const Node* node, std::size_t offset, std::size_t start, std::size_t end, Fn& fn) {
+        while (node != nullptr) {
+            const auto left_size = PieceTable::size(node->left_);
+            const auto piece_start = offset + left_size;
+            const auto piece_end = piece_start + node->len_;
+
+            if (start < piece_start) { PieceTable::for_each_chunk(node->left_.get(), offset, start, end, fn); }
+            if (start < piece_end && end > piece_start) {
+                const auto from = std::max(start, piece_start) - piece_start;
+                const auto to = std::min(end, piece_end) - piece_start;
+                fn(std::string_view{node->data_ + from, to - from});
+            }
+            if (end <= piece_end) { return; }
+
+            // Tail iteration into the right subtree.
+            offset = piece_end;
+            node = node->right_.get();
+        }
+    }
+};
+
+#endif
@@ -1,7 +1,7 @@
 #include "property_map.hpp"
 
-#include <algorithm>
-#include <ranges>
+#include <optional>
+#include <variant>
 
 #include <sol/protected_function.hpp>
 #include <sol/state.hpp>
@@ -10,74 +10,52 @@
 #include "../types/property.hpp"
 #include "../util/assert.hpp"
 
-void PropertyMap::add(const std::size_t start, const std::size_t end, const std::string& key, sol::object value) {
+void PropertyMap::add(const std::size_t start, const std::size_t end, const Atom key, PropertyValue value) {
     ASSERT(start <= end, "");
 
-    // Remove previously existing properties with the same key to replace them.
-    this->remove(start, end, key);
-
-    Property prop{.start_ = start, .end_ = end, .key_ = key, .value_ = std::move(value)};
-    this->properties_[key].insert(
-        std::ranges::lower_bound(this->properties_[key], start, {}, &Property::start_), std::move(prop));
-}
+    auto& tree = this->properties_[key];
+    auto prop = Property{.start_ = start, .end_ = end, .key_ = key, .value_ = std::move(value)};
 
-void PropertyMap::remove(const std::size_t start, const std::size_t end, const std::string_view key) {
-    ASSERT(start <= end, "");
+    // A property with the same range is updated in place, since it is the only one overlapping the range.
+    if (tree.assign(prop)) { return; }
 
-    auto it = this->properties_.find(std::string(key));
-    if (it == this->properties_.end() || it->second.empty()) { return; }
-    auto& vec = it->second;
+    // Remove previously existing properties with the same key to replace them.
+    tree.remove(start, end);
+    tree.insert(std::move(prop));
+}
 
-    auto read = std::ranges::upper_bound(vec, start, {}, &Property::start_);
-    if (read != vec.begin() && std::prev(read)->end_ > start) { read = std::prev(read); }
-    auto write = read;
-    std::optional<Property> right{};
+void PropertyMap::add_all(const Atom key, std::vector<Property> props) {
+    if (props.empty()) { return; }
 
-    while (read != vec.end()) {
-        if (!read->overlaps(start, end)) {
-            if (read->start_ >= end) { break; }
+    auto& tree = this->properties_[key];
 
-            if (read != write) { *write = std::move(*read); }
-            ++write;
-            ++read;
+    // Sorted, disjoint properties starting behind all existing ones can be appended without replacing anything. This is
+    // the common case of styling a freshly inserted text front to back.
+    auto append = tree.empty() || props.front().start_ >= tree.last()->end_;
+    for (auto idx{1UZ}; append && idx < props.size(); idx += 1) { append = props[idx - 1].end_ <= props[idx].start_; }
 
-            continue;
-        }
+    for (auto& prop: props) {
+        ASSERT(prop.start_ <= prop.end_, "");
 
-        auto keep{true};
-        if (read->start_ >= start && read->end_ <= end) {
-            keep = false;
-        } else if (read->start_ < start && read->end_ > end) {
-            Property tmp = *read;
-            tmp.start_ = end;
-            right = std::move(tmp);
-
-            // Truncate this to be the left side split.
-            read->end_ = start;
-            keep = true;
-        } else if (read->start_ < start) {
-            read->end_ = start;
-            keep = true;
+        if (append) {
+            prop.key_ = key;
+            tree.push_back(std::move(prop));
         } else {
-            read->start_ = end;
-            keep = true;
+            this->add(prop.start_, prop.end_, key, std::move(prop.value_));
         }
-
-        if (keep) {
-            if (read != write) { *write = std::move(*read); }
-            ++write;
-        }
-
-        ++read;
     }
+}
 
-    if (read != write && read != vec.end()) { write = std::move(read, vec.end(), write); }
-    vec.erase(write, vec.end());
+void PropertyMap::remove(const std::size_t start, const std::size_t end, const Atom key) {
+    ASSERT(start <= end, "");
+
+    auto it = this->properties_.find(key);
+    if (it == this->properties_.end() || it->second.empty()) { return; }
 
-    if (right) { vec.insert(std::ranges::upper_bound(vec, right->start_, {}, &Property::start_), std::move(*right)); }
+    it->second.remove(start, end);
 }
 
-void PropertyMap::clear(const sol::optional<std::string>& key) {
+void PropertyMap::clear(const std::optional<Atom> key) {
     if (key) {
         this->properties_.erase(*key);
     } else {
@@ -85,16 +63,8 @@ void PropertyMap::clear(const sol::optional<std::string>& key) {
     }
 }
 
-auto PropertyMap::get_property(const std::size_t pos, const std::string_view key) const -> sol::object {
-    auto it = this->properties_.find(std::string(key));
-    if (it == this->properties_.end() || it->second.empty()) { return sol::lua_nil; }
-
-    auto end = std::ranges::upper_bound(it->second, pos, {}, &Property::start_);
-
-    if (end != it->second.begin()) {
-        const auto& prop = *std::prev(end);
-        if (prop.contains(pos)) { return prop.value_; }
-    }
+auto PropertyMap::get_property(const std::size_t pos, const Atom key, sol::state& lua) const -> sol::object {
+    if (const auto* const prop = this->get_raw_property(pos, key); prop) { return prop->value_.to_lua(lua); }
 
     return sol::lua_nil;
 }
@@ -103,143 +73,99 @@ auto PropertyMap::get_properties(const std::size_t pos, sol::state& lua) const -
     sol::table res = lua.create_table();
 
     for (const auto& [key, val]: this->properties_) {
-        auto end = std::ranges::upper_bound(val, pos, {}, &Property::start_);
-        for (const auto& property: std::ranges::subrange(val.begin(), end)) {
-            if (property.contains(pos)) { res[key][property.key_] = property.value_; }
+        if (const auto* const prop = val.find(pos); prop) {
+            res[key.name()][prop->key_.name()] = prop->value_.to_lua(lua);
         }
     }
 
     return res;
 }
 
-auto PropertyMap::get_all_properties(const std::string_view key, sol::state& lua) const -> sol::table {
+auto PropertyMap::get_all_properties(const Atom key, sol::state& lua) const -> sol::table {
     auto res = lua.create_table();
 
-    for (const auto& [pkey, val]: this->properties_) {
-        auto idx = 1UZ;
-        auto group = lua.create_table();
-        for (const auto& prop: val) {
-            if (prop.key_ == key) {
-                auto item = lua.create_table();
-                item["start"] = prop.start_;
-                item["stop"] = prop.end_;
-                item["value"] = prop.value_;
-                group[idx++] = item;
-            }
-        }
+    auto it = this->properties_.find(key);
+    if (it == this->properties_.end() || it->second.empty()) { return res; }
 
-        if (idx != 1) { res[pkey] = group; }
-    }
+    auto idx = 1UZ;
+    auto group = lua.create_table();
+    it->second.for_each([&](const Property& prop) -> void {
+        auto item = lua.create_table();
+        item["start"] = prop.start_;
+        item["stop"] = prop.end_;
+        item["value"] = prop.value_.to_lua(lua);
+        group[idx++] = item;
+    });
+    res[key.name()] = group;
 
     return res;
 }
 
-auto PropertyMap::get_raw_property(const std::size_t pos, const std::string_view key) const -> const Property* {
-    auto it = this->properties_.find(std::string(key));
-    if (it == this->properties_.end() || it->second.empty()) { return nullptr; }
+auto PropertyMap::get_properties_in_range(
+    const std::size_t start, const std::size_t end, const std::optional<Atom> key, sol::state& lua) const
+    -> sol::table {
+    ASSERT(start <= end, "");
 
-    auto end = std::ranges::upper_bound(it->second, pos, {}, &Property::start_);
+    auto res = lua.create_table();
 
-    if (it->second.begin() != end) {
-        const auto& prop = *std::prev(end);
-        if (prop.contains(pos)) { return &prop; }
-    }
-    return nullptr;
-}
+    auto collect = [&](const Atom name, const PropertyTree& tree) -> void {
+        auto idx = 1UZ;
+        sol::table group{};
+        tree.for_each_in(start, end, [&](const Property& prop) -> void {
+            if (!group.valid()) { group = lua.create_table(); }
+
+            auto item = lua.create_table();
+            item["start"] = prop.start_;
+            item["stop"] = prop.end_;
+            item["value"] = prop.value_.to_lua(lua);
+            group[idx++] = item;
+        });
+        if (group.valid()) { res[name.name()] = group; }
+    };
 
-void PropertyMap::update_on_insert(const std::size_t pos, const std::size_t len) {
-    for (auto& [_, val]: this->properties_) {
-        if (val.empty()) { continue; }
-
-        auto it = std::ranges::upper_bound(val, pos, {}, &Property::start_);
-        if (it != val.begin() && std::prev(it)->end_ > pos) { it--; }
-
-        for (; it != val.end(); it++) {
-            if (it->start_ >= pos) {
-                it->start_ += len;
-                it->end_ += len;
-            } else if (it->end_ > pos) {
-                it->end_ += len;
-            }
-        }
+    if (key) {
+        auto it = this->properties_.find(*key);
+        if (it != this->properties_.end()) { collect(it->first, it->second); }
+    } else {
+        for (const auto& [name, tree]: this->properties_) { collect(name, tree); }
     }
-}
-
-void PropertyMap::update_on_remove(const std::size_t start, const std::size_t end) {
-    const auto len = end - start;
 
-    for (auto& [_, val]: this->properties_) {
-        if (val.empty()) { continue; }
-
-        auto read = std::ranges::upper_bound(val, start, {}, &Property::start_);
-        if (read != val.begin() && std::prev(read)->end_ > start) { read = std::prev(read); }
-        auto write = read;
+    return res;
+}
 
-        while (read != val.end()) {
-            if (read->end_ <= start) {
-                // Sync heads and increment.
-                if (write != read) { *write = std::move(*read); }
-                write++;
-                read++;
+auto PropertyMap::get_raw_property(const std::size_t pos, const Atom key) const -> const Property* {
+    auto it = this->properties_.find(key);
+    if (it == this->properties_.end()) { return nullptr; }
 
-                continue;
-            }
-
-            auto keep{true};
-            if (read->start_ >= end) { // Entirely after: Shift left.
-                read->start_ -= len;
-                read->end_ -= len;
-            } else if (read->start_ >= start && read->end_ <= end) { // Overlaps entirely: Remove.
-                keep = false;
-            } else if (read->start_ < start && read->end_ > end) { // Contains removal: Shrink.
-                read->end_ -= len;
-            } else if (read->start_ < start) { // Ends in removal: Truncate.
-                read->end_ = start;
-            } else { // Starts in removal: Truncate start.
-                read->start_ = start;
-                read->end_ -= len;
-            }
+    return it->second.find(pos);
+}
 
-            if (keep) {
-                if (write != read) { *write = std::move(*read); }
-                write++;
-            }
+void PropertyMap::update_on_insert(const std::size_t pos, const std::size_t len) {
+    for (auto& [_, val]: this->properties_) { val.shift_on_insert(pos, len); }
+}
 
-            read++;
-        }
+void PropertyMap::update_on_remove(const std::size_t start, const std::size_t end) {
+    for (auto& [_, val]: this->properties_) { val.shift_on_remove(start, end); }
+}
 
-        // Truncate old vector.
-        val.erase(write, val.end());
-    }
+void PropertyMap::update_on_edits(const std::vector<Edit>& edits) {
+    for (auto& [_, val]: this->properties_) { val.shift_on_edits(edits); }
 }
 
-void PropertyMap::merge(const std::string_view key) {
-    auto it = this->properties_.find(std::string(key));
-    if (it == this->properties_.end() || it->second.empty()) { return; }
+void PropertyMap::merge(const Atom key) {
+    auto it = this->properties_.find(key);
+    if (it == this->properties_.end()) { return; }
 
-    auto& val = it->second;
-    // Read head.
-    auto read = val.begin();
-    // Write head.
-    auto write = val.begin();
+    it->second.coalesce();
+}
 
-    *write = std::move(*read);
-    read++;
+void PropertyMap::begin_generation(const Atom key) { this->properties_[key].begin_generation(); }
 
-    while (read != val.end()) {
-        if (read->start_ <= write->end_) {
-            // Overlapping or adjacent, merge them
-            write->end_ = std::max(write->end_, read->end_);
-        } else {
-            // Disjoint, advance write head
-            write++;
-            if (write != read) { *write = std::move(*read); }
-        }
-        read++;
-    }
+void PropertyMap::end_generation(const Atom key) {
+    auto it = this->properties_.find(key);
+    if (it == this->properties_.end()) { return; }
 
-    write++;
-    val.erase(write, val.end());
+    it->second.sweep();
 }
 
 auto PropertyMap::size() const -> std::size_t { return this->properties_.size(); }
@@ -249,18 +175,34 @@ auto PropertyMap::clone(const sol::protected_function& deepcopy) const -> Proper
     PropertyMap copy;
 
     for (const auto& [key, properties]: properties_) {
-        std::vector<Property> tmp;
-        tmp.reserve(properties.size());
+        auto& tree = copy.properties_[key];
 
-        for (const auto& prop: properties) {
-            sol::object value = prop.value_;
-            if (prop.value_.is<sol::table>()) { value = deepcopy(prop.value_); }
-
-            tmp.push_back(Property{.start_ = prop.start_, .end_ = prop.end_, .key_ = prop.key_, .value_ = value});
-        }
+        properties.for_each([&](const Property& prop) -> void {
+            auto value = prop.value_;
+            if (const auto* const obj = std::get_if<sol::object>(&value.value_); obj && obj->is<sol::table>()) {
+                value.value_ = deepcopy(*obj).get<sol::object>();
+            }
 
-        copy.properties_[key] = std::move(tmp);
+            tree.push_back(Property{.start_ = prop.start_, .end_ = prop.end_, .key_ = prop.key_, .value_ = value});
+        });
     }
 
     return copy;
 }
+
+auto PropertyMap::from_spans(const Atom key, const sol::table& spans, const bool intern) -> std::vector<Property> {
+    const auto count = spans.size();
+    std::vector<Property> props{};
+    props.reserve(count);
+
+    for (auto idx{1UZ}; idx <= count; idx += 1) {
+        const sol::table span = spans[idx];
+        props.push_back(Property{
+            .start_ = span.get<std::size_t>("start"),
+            .end_ = span.get<std::size_t>("stop"),
+            .key_ = key,
+            .value_ = PropertyValue{span.get<sol::object>("value"), intern}});
+    }
+
+    return props;
+}
@@ -1,20 +1,28 @@
 #ifndef TEXT_PROPERTY_MAP_HPP_
 #define TEXT_PROPERTY_MAP_HPP_
 
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
 #include <sol/forward.hpp>
 
-#include "../types/property.hpp"
+#include "../types/atom.hpp"
+#include "../types/edit.hpp"
+#include "../types/property_value.hpp"
+#include "property_tree.hpp"
 
-/// The PropertyMap manages efficient storage and access to Properties.
+/// The PropertyMap manages efficient storage and access to Properties. The Properties of every key are kept in a
+/// PropertyTree, shifting them after an edit is O(log n) per key.
+///
+/// Properties that are fully recomputed (e.g. highlighting) should be written in generations instead of clearing and
+/// re-adding them, which reuses the storage of all unchanged properties.
 ///
 /// Text Properties on Documents must be managed through the API of this class and never directly inserted. Failure to
 /// do so can result in UB and possible slowdowns.
 struct PropertyMap {
 public:
-    std::unordered_map<std::string, std::vector<Property>> properties_{};
+    std::unordered_map<Atom, PropertyTree> properties_{};
 
 public:
     PropertyMap() = default;
@@ -25,31 +33,46 @@ public:
     auto operator=(PropertyMap&&) noexcept -> PropertyMap& = default;
 
     /// Adds or updates a property on a text range.
-    void add(std::size_t start, std::size_t end, const std::string& key, sol::object value);
+    void add(std::size_t start, std::size_t end, Atom key, PropertyValue value);
+    /// Adds or updates properties on multiple text ranges. Later properties replace earlier ones where they overlap.
+    void add_all(Atom key, std::vector<Property> props);
     /// Removes all matching properties in the given range.
-    void remove(std::size_t start, std::size_t end, std::string_view key);
+    void remove(std::size_t start, std::size_t end, Atom key);
     /// Removes all or matching properties.
-    void clear(const sol::optional<std::string>& key);
+    void clear(std::optional<Atom> key);
 
     /// Gets the matching property at that position.
     [[nodiscard]]
-    auto get_property(std::size_t pos, std::string_view key) const -> sol::object;
+    auto get_property(std::size_t pos, Atom key, sol::state& lua) const -> sol::object;
     /// Gets all properties at that position.
     [[nodiscard]]
     auto get_properties(std::size_t pos, sol::state& lua) const -> sol::table;
     /// Gets all properties with a specific key.
     [[nodiscard]]
-    auto get_all_properties(std::string_view key, sol::state& lua) const -> sol::table;
+    auto get_all_properties(Atom key, sol::state& lua) const -> sol::table;
+    /// Gets all or matching properties overlapping the range.
+    [[nodiscard]]
+    auto get_properties_in_range(
+        std::size_t start, std::size_t end, std::optional<Atom> key, sol::state& lua) const -> sol::table;
     /// Gets the matching raw Property object at that position.
     [[nodiscard]]
-    auto get_raw_property(std::size_t pos, std::string_view key) const -> const Property*;
+    auto get_raw_property(std::size_t pos, Atom key) const -> const Property*;
 
     /// Updates property ranges after insertion.
     void update_on_insert(std::size_t pos, std::size_t len);
     /// Updates property ranges after removal.
     void update_on_remove(std::size_t start, std::size_t end);
+    /// Updates property ranges after applying sorted, non-overlapping edits. The result equals removing and inserting
+    /// the text of every edit in order.
+    void update_on_edits(const std::vector<Edit>& edits);
     /// Merges overlapping properties.
-    void merge(std::string_view key);
+    void merge(Atom key);
+
+    /// Starts a new generation of properties with a specific key. Properties added before become stale and are
+    /// removed when the generation ends, unless they are added again with the same range.
+    void begin_generation(Atom key);
+    /// Ends the current generation of properties with a specific key, removing all stale ones.
+    void end_generation(Atom key);
 
     /// Count of properties set.
     [[nodiscard]]
@@ -59,6 +82,10 @@ public:
 
     [[nodiscard]]
     auto clone(const sol::protected_function& deepcopy) const -> PropertyMap;
+
+    /// Converts a list of {start, stop, value} tables to properties. String values are interned if intern is set.
+    [[nodiscard]]
+    static auto from_spans(Atom key, const sol::table& spans, bool intern) -> std::vector<Property>;
 };
 
 #endif
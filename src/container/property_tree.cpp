@@ -0,0 +1,349 @@
+#include "property_tree.hpp"
+
+#include <algorithm>
+
+#include "../util/assert.hpp"
+
+auto PropertyTree::size() const -> std::size_t { return PropertyTree::count(this->root_); }
+auto PropertyTree::empty() const -> bool { return this->root_ == nullptr; }
+
+void PropertyTree::insert(Property prop) {
+    const auto start = prop.start_;
+
+    auto [left, right] = PropertyTree::split(std::move(this->root_), start);
+    this->root_ = PropertyTree::merge(
+        PropertyTree::merge(std::move(left), this->make_node(std::move(prop), this->generation_)), std::move(right));
+}
+
+auto PropertyTree::assign(const Property& prop) -> bool {
+    // Find the last node starting at or before the Property.
+    Node* found{nullptr};
+    auto* node = this->root_.get();
+    while (node != nullptr) {
+        PropertyTree::push(*node);
+
+        if (node->prop_.start_ <= prop.start_) {
+            found = node;
+            node = node->right_.get();
+        } else {
+            node = node->left_.get();
+        }
+    }
+
+    if (found == nullptr || found->prop_.start_ != prop.start_ || found->prop_.end_ != prop.end_) { return false; }
+
+    found->prop_.value_ = prop.value_;
+    found->generation_ = this->generation_;
+
+    return true;
+}
+
+void PropertyTree::push_back(Property prop) {
+    this->root_ = PropertyTree::merge(std::move(this->root_), this->make_node(std::move(prop), this->generation_));
+}
+
+void PropertyTree::remove(const std::size_t start, const std::size_t end) {
+    ASSERT(start <= end, "");
+
+    auto [left, rest] = PropertyTree::split(std::move(this->root_), start);
+    auto [middle, right] = PropertyTree::split(std::move(rest), end);
+
+    // Only the last Property starting before the range can reach into it, split it if it contains the range.
+    std::unique_ptr<Node> tail{nullptr};
+    if (auto* last = PropertyTree::back(left.get()); last != nullptr && last->prop_.end_ > start) {
+        if (last->prop_.end_ > end) {
+            auto prop = last->prop_;
+            prop.start_ = end;
+            tail = this->make_node(std::move(prop), last->generation_);
+        }
+
+        last->prop_.end_ = start;
+    }
+
+    // Properties starting inside the range are removed, except the last one if it reaches past the range.
+    if (auto* last = PropertyTree::back(middle.get()); last != nullptr && last->prop_.end_ > end) {
+        auto prop = std::move(last->prop_);
+        prop.start_ = end;
+        tail = this->make_node(std::move(prop), last->generation_);
+    }
+
+    this->root_ = PropertyTree::merge(PropertyTree::merge(std::move(left), std::move(tail)), std::move(right));
+}
+
+void PropertyTree::shift_on_insert(const std::size_t pos, const std::size_t len) {
+    if (len == 0) { return; }
+
+    auto [left, right] = PropertyTree::split(std::move(this->root_), pos);
+
+    // Properties containing pos are extended.
+    if (auto* last = PropertyTree::back(left.get()); last != nullptr && last->prop_.end_ > pos) {
+        last->prop_.end_ += len;
+    }
+    if (right) { right->delta_ += len; }
+
+    this->root_ = PropertyTree::merge(std::move(left), std::move(right));
+}
+
+void PropertyTree::shift_on_remove(const std::size_t start, const std::size_t end) {
+    ASSERT(start <= end, "");
+
+    if (start == end) { return; }
+
+    const auto len = end - start;
+    auto [left, rest] = PropertyTree::split(std::move(this->root_), start);
+    auto [middle, right] = PropertyTree::split(std::move(rest), end);
+
+    // Shrinks Properties containing the removal, truncates Properties ending in it.
+    if (auto* last = PropertyTree::back(left.get()); last != nullptr && last->prop_.end_ > start) {
+        last->prop_.end_ = last->prop_.end_ > end ? last->prop_.end_ - len : start;
+    }
+
+    // Properties inside the removal are dropped, except empty ones at its start. The start of a Property reaching past
+    // the removal is truncated.
+    std::vector<std::unique_ptr<Node>> nodes{};
+    PropertyTree::flatten(std::move(middle), nodes);
+
+    std::unique_ptr<Node> kept{nullptr};
+    for (auto& node: nodes) {
+        auto& prop = node->prop_;
+        if (prop.start_ == start && prop.end_ == start) {
+            kept = PropertyTree::merge(std::move(kept), std::move(node));
+        } else if (prop.end_ > end) {
+            prop.start_ = start;
+            prop.end_ -= len;
+            kept = PropertyTree::merge(std::move(kept), std::move(node));
+        }
+    }
+
+    // Unsigned wrap-around makes subtracting the length from the pending shift well defined.
+    if (right) { right->delta_ -= len; }
+
+    this->root_ = PropertyTree::merge(PropertyTree::merge(std::move(left), std::move(kept)), std::move(right));
+}
+
+void PropertyTree::shift_on_edits(const std::vector<Edit>& edits) {
+    if (edits.empty()) { return; }
+
+    // Shift of positions behind the first n edits, wrapping around for negative shifts.
+    std::vector<std::size_t> deltas{};
+    deltas.reserve(edits.size() + 1);
+    deltas.push_back(0);
+    for (const auto& edit: edits) { deltas.push_back(deltas.back() + edit.text_.size() - (edit.end_ - edit.start_)); }
+
+    std::vector<std::unique_ptr<Node>> nodes{};
+    PropertyTree::flatten(std::move(this->root_), nodes);
+
+    // Properties are disjoint and in order, so the edits ending before a Property never reach the following ones.
+    auto first{0UZ};
+    for (auto& node: nodes) {
+        auto& prop = node->prop_;
+        while (first < edits.size() && edits[first].end_ < prop.start_) { first += 1; }
+
+        prop.start_ += deltas[first];
+        prop.end_ += deltas[first];
+
+        // Apply the edits reaching the Property like shift_on_remove and shift_on_insert.
+        auto kept = true;
+        for (auto idx = first; kept && idx < edits.size(); idx += 1) {
+            const auto& edit = edits[idx];
+            const auto start = edit.start_ + deltas[idx];
+            if (start > prop.end_) { break; }
+
+            const auto end = start + (edit.end_ - edit.start_);
+            if (start < end) {
+                if (prop.start_ < start) {
+                    if (prop.end_ > start) { prop.end_ = prop.end_ > end ? prop.end_ - (end - start) : start; }
+                } else if (prop.start_ >= end) {
+                    prop.start_ -= end - start;
+                    prop.end_ -= end - start;
+                } else if (prop.end_ > end) {
+                    prop.start_ = start;
+                    prop.end_ -= end - start;
+                } else {
+                    kept = prop.start_ == start && prop.end_ == start;
+                }
+            }
+
+            if (const auto len = edit.text_.size(); len > 0) {
+                if (prop.start_ >= start) {
+                    prop.start_ += len;
+                    prop.end_ += len;
+                } else if (prop.end_ > start) {
+                    prop.end_ += len;
+                }
+            }
+        }
+
+        if (kept) { this->root_ = PropertyTree::merge(std::move(this->root_), std::move(node)); }
+    }
+}
+
+void PropertyTree::coalesce() {
+    std::vector<std::unique_ptr<Node>> nodes{};
+    PropertyTree::flatten(std::move(this->root_), nodes);
+
+    // The tree is rebuilt from the flattened nodes, the node extended last is always the last node of the tree.
+    Node* prev{nullptr};
+    for (auto& node: nodes) {
+        if (prev != nullptr && node->prop_.start_ <= prev->prop_.end_) {
+            prev->prop_.end_ = std::max(prev->prop_.end_, node->prop_.end_);
+            prev->generation_ = std::max(prev->generation_, node->generation_);
+            continue;
+        }
+
+        prev = node.get();
+        this->root_ = PropertyTree::merge(std::move(this->root_), std::move(node));
+    }
+}
+
+void PropertyTree::begin_generation() { this->generation_ += 1; }
+
+void PropertyTree::sweep() { this->root_ = PropertyTree::sweep(std::move(this->root_), this->generation_); }
+
+auto PropertyTree::last() const -> const Property* {
+    auto* node = PropertyTree::back(this->root_.get());
+
+    return node != nullptr ? &node->prop_ : nullptr;
+}
+
+auto PropertyTree::find(const std::size_t pos) const -> const Property* {
+    // Find the last Property starting at or before pos.
+    const Property* prop{nullptr};
+    auto* node = this->root_.get();
+    while (node != nullptr) {
+        PropertyTree::push(*node);
+
+        if (node->prop_.start_ <= pos) {
+            prop = &node->prop_;
+            node = node->right_.get();
+        } else {
+            node = node->left_.get();
+        }
+    }
+
+    return prop != nullptr && prop->contains(pos) ? prop : nullptr;
+}
+
+auto PropertyTree::next(const std::size_t pos) const -> const Property* {
+    // Ends are ordered like starts since Properties are disjoint.
+    const Property* prop{nullptr};
+    auto* node = this->root_.get();
+    while (node != nullptr) {
+        PropertyTree::push(*node);
+
+        const auto& curr = node->prop_;
+        if (curr.end_ > pos || (curr.end_ == pos && curr.start_ == curr.end_)) {
+            prop = &curr;
+            node = node->left_.get();
+        } else {
+            node = node->right_.get();
+        }
+    }
+
+    return prop;
+}
+
+auto PropertyTree::make_node(Property prop, const std::uint32_t generation) -> std::unique_ptr<Node> {
+    return std::make_unique<Node>(Node{
+        .prop_ = std::move(prop),
+        .delta_ = 0,
+        .count_ = 1,
+        .generation_ = generation,
+        .priority_ = static_cast<std::uint32_t>(this->rng_())});
+}
+
+auto PropertyTree::count(const std::unique_ptr<Node>& node) -> std::size_t { return node ? node->count_ : 0; }
+
+void PropertyTree::update(Node& node) {
+    node.count_ = PropertyTree::count(node.left_) + 1 + PropertyTree::count(node.right_);
+}
+
+void PropertyTree::push(Node& node) {
+    if (node.delta_ == 0) { return; }
+
+    node.prop_.start_ += node.delta_;
+    node.prop_.end_ += node.delta_;
+    if (node.left_) { node.left_->delta_ += node.delta_; }
+    if (node.right_) { node.right_->delta_ += node.delta_; }
+    node.delta_ = 0;
+}
+
+auto PropertyTree::back(Node* node) -> Node* {
+    while (node != nullptr) {
+        PropertyTree::push(*node);
+        if (node->right_ == nullptr) { return node; }
+
+        node = node->right_.get();
+    }
+
+    return nullptr;
+}
+
+auto PropertyTree::split(std::unique_ptr<Node> node, const std::size_t pos)
+    -> std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>> {
+    if (!node) { return {nullptr, nullptr}; }
+
+    PropertyTree::push(*node);
+
+    if (node->prop_.start_ < pos) {
+        auto [left, right] = PropertyTree::split(std::move(node->right_), pos);
+        node->right_ = std::move(left);
+        PropertyTree::update(*node);
+
+        return {std::move(node), std::move(right)};
+    }
+
+    auto [left, right] = PropertyTree::split(std::move(node->left_), pos);
+    node->left_ = std::move(right);
+    PropertyTree::update(*node);
+
+    return {std::move(left), std::move(node)};
+}
+
+auto PropertyTree::merge(std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs) -> std::unique_ptr<Node> {
+    if (!lhs) { return rhs; }
+    if (!rhs) { return lhs; }
+
+    if (lhs->priority_ > rhs->priority_) {
+        PropertyTree::push(*lhs);
+        lhs->right_ = PropertyTree::merge(std::move(lhs->right_), std::move(rhs));
+        PropertyTree::update(*lhs);
+
+        return lhs;
+    }
+
+    PropertyTree::push(*rhs);
+    rhs->left_ = PropertyTree::merge(std::move(lhs), std::move(rhs->left_));
+    PropertyTree::update(*rhs);
+
+    return rhs;
+}
+
+void PropertyTree::flatten(std::unique_ptr<Node> node, std::vector<std::unique_ptr<Node>>& nodes) {
+    while (node) {
+        PropertyTree::push(*node);
+        PropertyTree::flatten(std::move(node->left_), nodes);
+
+        // Tail iteration into the right subtree.
+        auto right = std::move(node->right_);
+        node->count_ = 1;
+        nodes.push_back(std::move(node));
+        node = std::move(right);
+    }
+}
+
+auto PropertyTree::sweep(std::unique_ptr<Node> node, const std::uint32_t generation) -> std::unique_ptr<Node> {
+    if (!node) { return nullptr; }
+
+    PropertyTree::push(*node);
+    node->left_ = PropertyTree::sweep(std::move(node->left_), generation);
+    node->right_ = PropertyTree::sweep(std::move(node->right_), generation);
+
+    if (node->generation_ != generation) {
+        return PropertyTree::merge(std::move(node->left_), std::move(node->right_));
+    }
+
+    PropertyTree::update(*node);
+
+    return node;
+}
@@ -0,0 +1,184 @@
+#ifndef PROPERTY_TREE_HPP_
+#define PROPERTY_TREE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "../types/edit.hpp"
+#include "../types/property.hpp"
+
+/// The PropertyTree stores the disjoint Properties of a single key in a randomized balanced tree (treap) ordered by
+/// their start. Every subtree carries a pending shift that is only applied to its nodes when they are visited, making
+/// shifting all Properties behind an edit O(log n) instead of touching every one of them.
+///
+/// Pending shifts are pushed down along every visited path, including on reads. Pointers to Properties returned by
+/// reads therefore hold their true bounds and stay valid until the tree is modified.
+///
+/// Every Property is tagged with the generation it was written in. Rewriting a Property with the same range reuses its
+/// node, so restyling a text in a new generation and sweeping the Properties of older generations afterwards neither
+/// frees nor allocates nodes for unchanged ranges.
+struct PropertyTree {
+private:
+    struct Node {
+    public:
+        Property prop_;
+        /// Pending shift of all Properties in this subtree, including this one. Negative shifts wrap around.
+        std::size_t delta_;
+        /// Total count of Properties in this subtree.
+        std::size_t count_;
+        /// Generation the Property was written in.
+        std::uint32_t generation_;
+        std::uint32_t priority_;
+
+        std::unique_ptr<Node> left_{nullptr};
+        std::unique_ptr<Node> right_{nullptr};
+    };
+
+private:
+    // Reads push pending shifts down, which does not change the observable state of the tree.
+    mutable std::unique_ptr<Node> root_{nullptr};
+    /// Generation newly written Properties are tagged with.
+    std::uint32_t generation_{0};
+
+    std::minstd_rand rng_{};
+
+public:
+    PropertyTree() = default;
+
+    PropertyTree(const PropertyTree&) = delete;
+    auto operator=(const PropertyTree&) -> PropertyTree& = delete;
+    PropertyTree(PropertyTree&&) noexcept = default;
+    auto operator=(PropertyTree&&) noexcept -> PropertyTree& = default;
+
+    /// Gets the count of Properties.
+    [[nodiscard]]
+    auto size() const -> std::size_t;
+    [[nodiscard]]
+    auto empty() const -> bool;
+
+    /// Inserts a Property before all Properties starting at or after it. The Property must not overlap others.
+    void insert(Property prop);
+    /// Replaces the value of the Property with the same range, returning false if there is none.
+    auto assign(const Property& prop) -> bool;
+    /// Appends a Property behind all others. The Property must not start before any other.
+    void push_back(Property prop);
+    /// Removes the range from all Properties, truncating or splitting Properties partially inside it.
+    void remove(std::size_t start, std::size_t end);
+
+    /// Merges overlapping or adjacent Properties, the merged Property keeps the first value.
+    void coalesce();
+
+    /// Starts a new generation. Properties written before are stale until they are rewritten.
+    void begin_generation();
+    /// Removes all stale Properties.
+    void sweep();
+
+    /// Updates Property ranges after insertion.
+    void shift_on_insert(std::size_t pos, std::size_t len);
+    /// Updates Property ranges after removal.
+    void shift_on_remove(std::size_t start, std::size_t end);
+    /// Updates Property ranges after applying sorted, non-overlapping edits, as if every edit was a removal followed by
+    /// an insertion. Visits every Property once instead of shifting the tree per edit.
+    void shift_on_edits(const std::vector<Edit>& edits);
+
+    /// Gets the last Property.
+    [[nodiscard]]
+    auto last() const -> const Property*;
+    /// Gets the Property containing pos.
+    [[nodiscard]]
+    auto find(std::size_t pos) const -> const Property*;
+    /// Gets the first Property that does not end before pos. Properties ending at pos are skipped unless they are
+    /// empty.
+    [[nodiscard]]
+    auto next(std::size_t pos) const -> const Property*;
+
+    /// Calls fn with every Property in order. If fn returns a bool, the iteration stops once it returns false.
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        PropertyTree::for_each(this->root_.get(), fn);
+    }
+    /// Calls fn with every Property overlapping the range in order, only visiting O(log n) other Properties. If fn
+    /// returns a bool, the iteration stops once it returns false.
+    template<typename Fn>
+    void for_each_in(const std::size_t start, const std::size_t end, Fn&& fn) const {
+        PropertyTree::for_each_in(this->root_.get(), start, end, fn);
+    }
+
+private:
+    auto make_node(Property prop, std::uint32_t generation) -> std::unique_ptr<Node>;
+
+    [[nodiscard]]
+    static auto count(const std::unique_ptr<Node>& node) -> std::size_t;
+    static void update(Node& node);
+    /// Applies the pending shift of the node to its Property and hands it down to its children.
+    static void push(Node& node);
+    /// Gets the last node of the tree with its true bounds.
+    [[nodiscard]]
+    static auto back(Node* node) -> Node*;
+    /// Splits the tree into the Properties starting before pos and the rest.
+    [[nodiscard]]
+    static auto split(std::unique_ptr<Node> node, std::size_t pos)
+        -> std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>>;
+    /// Merges two trees, all Properties of lhs preceding all Properties of rhs.
+    [[nodiscard]]
+    static auto merge(std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs) -> std::unique_ptr<Node>;
+    /// Detaches all nodes of the tree and appends them to nodes in order.
+    static void flatten(std::unique_ptr<Node> node, std::vector<std::unique_ptr<Node>>& nodes);
+    /// Removes all nodes not of the generation from the tree.
+    [[nodiscard]]
+    static auto sweep(std::unique_ptr<Node> node, std::uint32_t generation) -> std::unique_ptr<Node>;
+
+    template<typename Fn>
+    static auto for_each(Node* node, Fn& fn) -> bool {
+        while (node != nullptr) {
+            PropertyTree::push(*node);
+            if (!PropertyTree::for_each(node->left_.get(), fn)) { return false; }
+
+            const Property& prop = node->prop_;
+            if constexpr (std::is_same_v<std::invoke_result_t<Fn&, const Property&>, bool>) {
+                if (!fn(prop)) { return false; }
+            } else {
+                fn(prop);
+            }
+
+            // Tail iteration into the right subtree.
+            node = node->right_.get();
+        }
+
+        return true;
+    }
+
+    template<typename Fn>
+    static auto for_each_in(Node* node, const std::size_t start, const std::size_t end, Fn& fn) -> bool {
+        while (node != nullptr) {
+            PropertyTree::push(*node);
+
+            // Properties before the node end at its start at the latest, they can only overlap if it starts in the
+            // range.
+            const Property& prop = node->prop_;
+            if (prop.start_ >= start && !PropertyTree::for_each_in(node->left_.get(), start, end, fn)) { return false; }
+
+            if (prop.overlaps(start, end)) {
+                if constexpr (std::is_same_v<std::invoke_result_t<Fn&, const Property&>, bool>) {
+                    if (!fn(prop)) { return false; }
+                } else {
+                    fn(prop);
+                }
+            }
+
+            // Properties behind the node start at its start at the earliest.
+            if (prop.start_ >= end) { break; }
+
+            // Tail iteration into the right subtree.
+            node = node->right_.get();
+        }
+
+        return true;
+    }
+};
+
+#endif
@@ -2,10 +2,26 @@
 
 #include "document.hpp"
 #include "document_view.hpp"
+#include "types/atom.hpp"
 #include "util/assert.hpp"
 #include "util/math.hpp"
 #include "util/utf8.hpp"
 
+namespace {
+    /// Gets the length of the nth line, not counting the newline character.
+    auto line_length(const Document& doc, const std::size_t nth) -> std::size_t {
+        const auto end = doc.line_end_byte(nth);
+        const auto len = end - doc.line_begin_byte(nth);
+
+        return len > 0 && doc.at(end - 1) == '\n' ? len - 1 : len;
+    }
+
+    /// Copies the UTF-8 character starting at pos, without reading past end.
+    auto char_at(const Document& doc, const std::size_t pos, const std::size_t end) -> std::string {
+        return doc.slice(pos, std::min(pos + utf8::len(doc.at(pos)), end));
+    }
+} // namespace
+
 void Cursor::up(const DocumentView& view, const std::size_t n) {
     auto tab_width{4UZ};
     if (const sol::optional<std::size_t> t = view.properties_["tab_width"]; t) { tab_width = *t; }
@@ -17,17 +33,16 @@ void Cursor::up(const DocumentView& view, const std::size_t n) {
     const auto row = this->pos_.row_;
     auto col{0UZ};
     while (this->pos_.row_ == row) {
-        const auto line = view.doc_->line(this->pos_.row_);
-        if (const auto len = line.ends_with('\n') ? line.size() - 1 : line.size(); this->pos_.col_ >= len) { break; }
+        if (this->pos_.col_ >= line_length(*view.doc_, this->pos_.row_)) { break; }
 
         auto atom_width{0UZ};
         const auto point = this->point(view);
 
-        if (const auto* const property = view.get_raw_view_property(point, "replacement")) {
-            atom_width = utf8::str_width(property->value_.as<std::string_view>(), col, tab_width);
+        if (const auto* const property = view.get_raw_view_property(point, atoms::REPLACEMENT)) {
+            atom_width = utf8::str_width(property->value_.string().value_or(""), col, tab_width);
         } else {
-            atom_width =
-                utf8::char_width(line.substr(this->pos_.col_, utf8::len(line[this->pos_.col_])), col, tab_width);
+            const auto ch = char_at(*view.doc_, point, view.doc_->line_end_byte(this->pos_.row_));
+            atom_width = utf8::char_width(ch, col, tab_width);
         }
 
         if (col + atom_width > this->pref_col_) { break; }
@@ -53,17 +68,16 @@ void Cursor::down(const DocumentView& view, const std::size_t n) {
     const auto row = this->pos_.row_;
     auto col{0UZ};
     while (this->pos_.row_ == row) {
-        const auto line = view.doc_->line(this->pos_.row_);
-        if (const auto len = line.ends_with('\n') ? line.size() - 1 : line.size(); this->pos_.col_ >= len) { break; }
+        if (this->pos_.col_ >= line_length(*view.doc_, this->pos_.row_)) { break; }
 
         auto atom_width{0UZ};
         const auto point = this->point(view);
 
-        if (const auto* const property = view.get_raw_view_property(point, "replacement")) {
-            atom_width = utf8::str_width(property->value_.as<std::string_view>(), col, tab_width);
+        if (const auto* const property = view.get_raw_view_property(point, atoms::REPLACEMENT)) {
+            atom_width = utf8::str_width(property->value_.string().value_or(""), col, tab_width);
         } else {
-            atom_width =
-                utf8::char_width(line.substr(this->pos_.col_, utf8::len(line[this->pos_.col_])), col, tab_width);
+            const auto ch = char_at(*view.doc_, point, view.doc_->line_end_byte(this->pos_.row_));
+            atom_width = utf8::char_width(ch, col, tab_width);
         }
 
         if (col + atom_width > this->pref_col_) { break; }
@@ -97,17 +111,18 @@ void Cursor::right(const DocumentView& view, const std::size_t n) {
 auto Cursor::current_char(const DocumentView& view) const -> std::size_t {
     if (this->pos_.row_ >= view.doc_->line_count()) { return WEOF; }
 
-    const auto line = view.doc_->line(this->pos_.row_);
-    if (this->pos_.col_ >= line.size()) { return '\n'; }
+    const auto begin = view.doc_->line_begin_byte(this->pos_.row_);
+    const auto end = view.doc_->line_end_byte(this->pos_.row_);
+    if (begin + this->pos_.col_ >= end) { return '\n'; }
 
-    return utf8::decode(line.substr(this->pos_.col_));
+    return utf8::decode(char_at(*view.doc_, begin + this->pos_.col_, end));
 }
 
 auto Cursor::step_forward(const DocumentView& view) -> bool {
     if (this->pos_.row_ >= view.doc_->line_count()) { return false; }
 
     const auto point = this->point(view);
-    if (const auto* const property = view.get_raw_view_property(point, "replacement"); property) {
+    if (const auto* const property = view.get_raw_view_property(point, atoms::REPLACEMENT); property) {
         if (property->end_ >= view.doc_->size()) { // Overflows the Document.
             this->_jump_to_end_of_file(view);
         } else {
@@ -117,11 +132,8 @@ auto Cursor::step_forward(const DocumentView& view) -> bool {
         return true;
     }
 
-    const auto line = view.doc_->line(this->pos_.row_);
-    auto len = line.size();
-
     // Do not treat the newline character as a "character".
-    if (line.ends_with('\n')) { len -= 1; }
+    const auto len = line_length(*view.doc_, this->pos_.row_);
 
     // End of line.
     if (this->pos_.col_ >= len) {
@@ -133,7 +145,7 @@ auto Cursor::step_forward(const DocumentView& view) -> bool {
         return true;
     }
 
-    this->pos_.col_ += utf8::len(line[this->pos_.col_]);
+    this->pos_.col_ += utf8::len(view.doc_->at(point));
 
     return true;
 }
@@ -141,12 +153,13 @@ auto Cursor::step_forward(const DocumentView& view) -> bool {
 auto Cursor::step_backward(const DocumentView& view) -> bool {
     auto moved{false};
     if (this->pos_.col_ > 0) {
-        const auto line = view.doc_->line(this->pos_.row_);
+        const auto begin = view.doc_->line_begin_byte(this->pos_.row_);
 
         // Move back one byte, then continue moving back until the start of the utf-8 byte sequence.
         // Continuation bytes start with 10xxxxxx.
         this->pos_.col_ -= 1;
-        while (this->pos_.col_ > 0 && (static_cast<unsigned char>(line[this->pos_.col_]) & 0xC0) == 0x80) {
+        while (this->pos_.col_ > 0 &&
+               (static_cast<unsigned char>(view.doc_->at(begin + this->pos_.col_)) & 0xC0) == 0x80) {
             this->pos_.col_ -= 1;
         }
 
@@ -154,11 +167,9 @@ auto Cursor::step_backward(const DocumentView& view) -> bool {
     } else {
         if (this->pos_.row_ > 0) {
             this->pos_.row_ -= 1;
-            const auto line = view.doc_->line(this->pos_.row_);
-            this->pos_.col_ = line.size();
 
             // Do not treat the newline character as a "character".
-            if (line.ends_with('\n')) { this->pos_.col_ = math::sub_sat(this->pos_.col_, 1UZ); }
+            this->pos_.col_ = line_length(*view.doc_, this->pos_.row_);
 
             moved = true;
         }
@@ -167,7 +178,7 @@ auto Cursor::step_backward(const DocumentView& view) -> bool {
     if (!moved) { return false; }
 
     const auto point = this->point(view);
-    if (const auto* const property = view.get_raw_view_property(point, "replacement"); property) {
+    if (const auto* const property = view.get_raw_view_property(point, atoms::REPLACEMENT); property) {
         this->point(view, property->start_);
     }
 
@@ -197,7 +208,7 @@ auto Cursor::peek_backward(const DocumentView& view) -> std::optional<std::size_
 void Cursor::point(const DocumentView& view, std::size_t point) {
     ASSERT(point <= view.doc_->size(), "");
 
-    if (const auto* const property = view.get_raw_view_property(point, "replacement")) {
+    if (const auto* const property = view.get_raw_view_property(point, atoms::REPLACEMENT)) {
         point = std::min(property->start_, point);
     }
 
@@ -221,11 +232,8 @@ void Cursor::_jump_to_beginning_of_line(const DocumentView& view) {
 }
 
 void Cursor::_jump_to_end_of_line(const DocumentView& view) {
-    const auto line = view.doc_->line(this->pos_.row_);
-    this->pos_.col_ = line.size();
-
     // Do not treat the newline character as a "character".
-    if (line.ends_with('\n')) { this->pos_.col_ = math::sub_sat(this->pos_.col_, 1UZ); }
+    this->pos_.col_ = line_length(*view.doc_, this->pos_.row_);
 
     auto tab_width{4UZ};
     if (const sol::optional<std::size_t> t = view.properties_["tab_width"]; t) { tab_width = *t; }
@@ -422,7 +430,7 @@ void Cursor::_next_empty_line(const DocumentView& view, const std::size_t n) {
     for (auto idx{0UZ}; idx < n; idx += 1) {
         auto found{false};
         for (auto y = this->pos_.row_ + 1; y < view.doc_->line_count(); y += 1) {
-            if (const auto line = view.doc_->line(y); line.empty() || line == "\n") {
+            if (line_length(*view.doc_, y) == 0) {
                 this->pos_.row_ = y;
                 this->pos_.col_ = 0;
                 found = true;
@@ -444,7 +452,7 @@ void Cursor::_prev_empty_line(const DocumentView& view, const std::size_t n) {
 
         auto found{false};
         for (auto y = this->pos_.row_ - 1;; y -= 1) {
-            if (const auto line = view.doc_->line(y); line.empty() || line == "\n") {
+            if (line_length(*view.doc_, y) == 0) {
                 this->pos_.row_ = y;
                 this->pos_.col_ = 0;
                 found = true;
@@ -551,7 +559,10 @@ EXIT:
 
 void Cursor::update_pref_col(const DocumentView& view, const std::size_t tab_width) {
     if (this->pos_.row_ < view.doc_->line_count()) {
-        this->pref_col_ = utf8::byte_to_idx(view.doc_->line(this->pos_.row_), this->pos_.col_, tab_width);
+        std::string buffer{};
+        const auto begin = view.doc_->line_begin_byte(this->pos_.row_);
+        const auto line = view.doc_->slice(begin, begin + this->pos_.col_, buffer);
+        this->pref_col_ = utf8::byte_to_idx(line, this->pos_.col_, tab_width);
     } else {
         this->pref_col_ = 0;
     }
@@ -3,7 +3,9 @@
 #include <ranges>
 
 #include <sol/state_view.hpp>
+#include <uv.h>
 
+#include "document_snapshot.hpp"
 #include "document_view.hpp"
 #include "editor.hpp"
 #include "regex.hpp"
@@ -11,12 +13,62 @@
 #include "types/position.hpp"
 #include "util/assert.hpp"
 #include "util/fs.hpp"
-#include "util/math.hpp"
+
+namespace {
+    /// Indexes the remainder of a mapped file on a worker thread.
+    struct IndexWork {
+    public:
+        /// Size of the pieces data is indexed in, limiting the temporary memory required by the LineIndex.
+        static constexpr std::size_t PIECE_SIZE{1024UZ * 1024UZ};
+
+        uv_work_t req_{};
+
+        std::weak_ptr<Document> doc_;
+        std::size_t generation_;
+        std::shared_ptr<const void> owner_;
+        std::string_view data_;
+        LineIndex index_{};
+    };
+
+    /// Reads or maps a file and indexes its first chunk on a worker thread.
+    struct LoadWork {
+    public:
+        uv_work_t req_{};
+
+        std::weak_ptr<Document> doc_;
+        std::size_t generation_;
+        std::filesystem::path path_;
+
+        /// Owner of the mapped file, nothing if the file was read into content.
+        std::shared_ptr<const void> owner_{nullptr};
+        std::weak_ptr<const fs::MappedFile> mapped_file_{};
+        std::string content_{};
+        /// First chunk of the file, indexed by index.
+        std::string_view data_{};
+        /// Remainder of the file to be indexed in the background.
+        std::string_view rest_{};
+        LineIndex index_{};
+        bool loaded_{false};
+    };
+
+    /// Writes a snapshot of a Document on a worker thread.
+    struct SaveWork {
+    public:
+        uv_work_t req_{};
+
+        std::weak_ptr<Document> doc_;
+        std::shared_ptr<const DocumentSnapshot> snapshot_;
+        std::filesystem::path path_;
+        /// Set if the path becomes the backing file of the Document.
+        bool assign_path_;
+        /// Set if hard links of the file may be kept by overwriting it in place.
+        bool keep_links_;
+        bool written_{false};
+    };
+} // namespace
 
 Document::Document(std::optional<std::filesystem::path> path, sol::state& lua)
-    : path_{std::move(path)}, properties_{lua.create_table()} {
-    this->build_line_indices();
-}
+    : path_{std::move(path)}, properties_{lua.create_table()} {}
 
 auto Document::views() -> std::vector<std::shared_ptr<DocumentView>> {
     std::vector<std::shared_ptr<DocumentView>> views;
@@ -32,6 +84,124 @@ auto Document::views() -> std::vector<std::shared_ptr<DocumentView>> {
     return views;
 }
 
+void Document::load() {
+    ASSERT(this->path_, "");
+
+    this->loading_ = true;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto* work = new LoadWork{
+        .doc_ = this->weak_from_this(),
+        .generation_ = this->load_generation_,
+        .path_ = *this->path_}; // NOLINT(bugprone-unchecked-optional-access)
+    work->req_.data = work;
+
+    uv_queue_work(
+        Editor::instance()->loop_, &work->req_,
+        [](uv_work_t* req) -> void {
+            // Runs on a worker thread, only touch the work.
+            auto* work = static_cast<LoadWork*>(req->data);
+
+            std::error_code err{};
+            if (std::filesystem::is_directory(work->path_, err)) { return; }
+
+            std::string_view data{};
+            const auto file_size = std::filesystem::file_size(work->path_, err);
+            if (!err && file_size >= Document::MAP_THRESHOLD) {
+                if (auto file = fs::map_file(work->path_)) {
+                    data = (*file)->view();
+                    work->mapped_file_ = *file;
+                    work->owner_ = std::move(*file);
+                }
+            }
+            if (!work->owner_) {
+                auto content = fs::read_file(work->path_);
+                if (!content) { return; }
+
+                work->content_ = std::move(*content);
+                data = work->content_;
+            }
+
+            // Only index the first chunk (up to a line break) of mapped files right away to make the Document
+            // interactive.
+            auto cut = data.size();
+            if (const auto pos = data.rfind('\n', Document::INDEX_CHUNK_SIZE - 1);
+                work->owner_ && pos != std::string_view::npos) {
+                cut = pos + 1;
+            }
+
+            work->data_ = data.substr(0, cut);
+            work->rest_ = data.substr(cut);
+            for (auto pos{0UZ}; pos < work->data_.size(); pos += IndexWork::PIECE_SIZE) {
+                work->index_.insert(work->index_.size(), work->data_.substr(pos, IndexWork::PIECE_SIZE));
+            }
+            work->loaded_ = true;
+        },
+        [](uv_work_t* req, const int status) -> void {
+            const std::unique_ptr<LoadWork> work{static_cast<LoadWork*>(req->data)};
+
+            // The Document may have been destroyed or cleared in the meantime.
+            const auto doc = work->doc_.lock();
+            if (!doc || !doc->loading_ || doc->load_generation_ != work->generation_) { return; }
+
+            if (status != 0 || !work->loaded_) {
+                doc->finish_loading();
+                return;
+            }
+
+            // Appending the file is not a modification.
+            const auto modified = doc->modified_;
+            doc->mapped_file_ = work->mapped_file_;
+            doc->append_indexed(work->data_, work->owner_, std::move(work->index_));
+            doc->modified_ = modified;
+
+            if (work->rest_.empty()) {
+                doc->finish_loading();
+            } else {
+                doc->index_in_background(std::move(work->owner_), work->rest_);
+                Editor::instance()->request_render();
+            }
+        });
+}
+
+void Document::index_in_background(std::shared_ptr<const void> owner, const std::string_view data) {
+    this->loading_ = true;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto* work = new IndexWork{
+        .doc_ = this->weak_from_this(),
+        .generation_ = this->load_generation_,
+        .owner_ = std::move(owner),
+        .data_ = data};
+    work->req_.data = work;
+
+    uv_queue_work(
+        Editor::instance()->loop_, &work->req_,
+        [](uv_work_t* req) -> void {
+            // Runs on a worker thread, only touch the immutable data and the private index.
+            auto* work = static_cast<IndexWork*>(req->data);
+            for (auto pos{0UZ}; pos < work->data_.size(); pos += IndexWork::PIECE_SIZE) {
+                work->index_.insert(work->index_.size(), work->data_.substr(pos, IndexWork::PIECE_SIZE));
+            }
+        },
+        [](uv_work_t* req, const int status) -> void {
+            const std::unique_ptr<IndexWork> work{static_cast<IndexWork*>(req->data)};
+
+            // The Document may have been destroyed or cleared in the meantime.
+            const auto doc = work->doc_.lock();
+            if (!doc || !doc->loading_ || doc->load_generation_ != work->generation_) { return; }
+
+            if (status == 0) {
+                // Appending the remainder is part of loading and not a modification.
+                const auto modified = doc->modified_;
+                doc->append_indexed(work->data_, std::move(work->owner_), std::move(work->index_));
+                doc->modified_ = modified;
+            }
+
+            doc->finish_loading();
+        });
+}
+
 void Document::save(std::optional<std::filesystem::path> path) {
     auto editor = Editor::instance();
 
@@ -40,48 +210,114 @@ void Document::save(std::optional<std::filesystem::path> path) {
         return;
     }
 
-    editor->emit_event("document::before-save", this->shared_from_this());
-
-    if (path) {
-        if (!fs::write_file(*path, this->data_, std::ios::out | std::ios::trunc)) {
-            editor->set_status_message("Failed to write file.", "error_message");
-            return;
-        }
+    if (this->loading_) {
+        editor->set_status_message("The file is still loading.", "info_message");
+        return;
+    }
 
-        this->path_ = std::move(path);
-        goto EXIT;
+    if (this->saving_) {
+        editor->set_status_message("The file is still being saved.", "info_message");
+        return;
     }
 
-    if (!fs::write_file(
-            *this->path_, this->data_, std::ios::out | std::ios::trunc)) { // NOLINT(bugprone-unchecked-optional-access)
-        editor->set_status_message("Failed to write file.", "error_message");
+    // The truncated part of a mapped file was replaced with zeros, writing it would corrupt the file.
+    if (const auto file = this->mapped_file_.lock(); file && file->truncated()) {
+        editor->set_status_message("The file was truncated by another program, reopen it.", "error_message");
         return;
     }
 
-EXIT:
-    this->modified_ = false;
-    editor->emit_event("document::after-save", this->shared_from_this());
+    editor->emit_event("document::before-save", this->shared_from_this());
+
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto* work = new SaveWork{
+        .doc_ = this->weak_from_this(),
+        .snapshot_ = this->snapshot(),
+        // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+        .path_ = path ? std::move(*path) : *this->path_,
+        .assign_path_ = path.has_value(),
+        // Overwriting a mapped file in place would change the data referencing it.
+        .keep_links_ = !this->mapped()};
+    work->req_.data = work;
+    this->saving_ = true;
+
+    // Writing to a temporary file and replacing the target also keeps mapped files valid, the mapping keeps
+    // referencing the replaced file.
+    uv_queue_work(
+        editor->loop_, &work->req_,
+        [](uv_work_t* req) -> void {
+            // Runs on a worker thread, only touch the snapshot.
+            auto* work = static_cast<SaveWork*>(req->data);
+
+            std::vector<std::string_view> chunks{};
+            work->snapshot_->for_each_chunk(
+                0, work->snapshot_->size(), [&](const std::string_view chunk) -> void { chunks.push_back(chunk); });
+            work->written_ = fs::replace_file(work->path_, chunks, work->keep_links_);
+        },
+        [](uv_work_t* req, const int status) -> void {
+            const std::unique_ptr<SaveWork> work{static_cast<SaveWork*>(req->data)};
+
+            const auto doc = work->doc_.lock();
+            if (!doc) { return; }
+            doc->saving_ = false;
+
+            auto editor = Editor::instance();
+            if (status != 0 || !work->written_) {
+                editor->set_status_message("Failed to write file.", "error_message");
+                return;
+            }
+
+            if (work->assign_path_) { doc->path_ = std::move(work->path_); }
+
+            // Edits made while saving are not part of the file.
+            if (doc->revision() == work->snapshot_->revision_) { doc->modified_ = false; }
+            editor->emit_event("document::after-save", doc);
+            editor->request_render();
+        });
 }
 
-auto Document::line_count() const -> std::size_t { return this->line_indices_.size(); }
+auto Document::mapped() const -> bool { return this->data_.has_externals(); }
+auto Document::loading() const -> bool { return this->loading_; }
+auto Document::saving() const -> bool { return this->saving_; }
+
+auto Document::line_count() const -> std::size_t { return this->line_index_.line_count(); }
 
 auto Document::size() const -> std::size_t { return this->data_.size(); }
 
+auto Document::revision() const -> std::size_t { return this->changes_.revision(); }
+
+auto Document::changes_since(const std::size_t revision) const -> std::optional<std::vector<Change>> {
+    ASSERT(revision <= this->changes_.revision(), "");
+
+    return this->changes_.since(revision);
+}
+
+auto Document::snapshot() const -> std::shared_ptr<const DocumentSnapshot> {
+    return std::make_shared<const DocumentSnapshot>(
+        this->changes_.revision(), this->data_.snapshot(), this->line_index_.snapshot());
+}
+
 void Document::insert(const std::size_t pos, const std::string_view data) {
     ASSERT(pos <= this->data_.size(), "");
 
+    if (!this->editable()) { return; }
+
     auto editor = Editor::instance();
     editor->emit_event("document::before-insert", this->shared_from_this(), pos, data.size());
 
     if (this->recording_transaction_ && !this->applying_transaction_) {
-        this->active_transaction_.operations_.emplace_back(Operation::Type::INSERT, pos, std::string(data));
+        this->active_transaction_.record_insert(pos, data);
     }
 
+    const auto anchors = this->anchor_cursors();
+
     this->data_.insert(pos, data);
     this->text_properties_.update_on_insert(pos, data.size());
+    this->markers_.update_on_insert(pos, data.size());
+    this->changes_.record(pos, 0, data.size());
     this->modified_ = true;
 
-    this->update_line_indices_on_insert(pos, data);
+    this->line_index_.insert(pos, data);
+    this->restore_cursors(anchors, pos);
 
     editor->emit_event("document::after-insert", this->shared_from_this(), pos, data.size());
 }
@@ -90,19 +326,25 @@ void Document::remove(const std::size_t start, const std::size_t end) {
     ASSERT(start <= end, "");
     ASSERT(end <= this->data_.size(), "");
 
+    if (!this->editable()) { return; }
+
     auto editor = Editor::instance();
     editor->emit_event("document::before-remove", this->shared_from_this(), start, end - start);
 
     if (this->recording_transaction_ && !this->applying_transaction_) {
-        this->active_transaction_.operations_.emplace_back(
-            Operation::Type::REMOVE, start, std::string(this->slice(start, end)));
+        this->active_transaction_.record_remove(start, this->data_.copy(start, end));
     }
 
-    this->data_.erase(start, end - start);
+    const auto anchors = this->anchor_cursors();
+
+    this->data_.remove(start, end);
     this->text_properties_.update_on_remove(start, end);
+    this->markers_.update_on_remove(start, end);
+    this->changes_.record(start, end - start, 0);
     this->modified_ = true;
 
-    this->update_line_indices_on_remove(start, end);
+    this->line_index_.remove(start, end);
+    this->restore_cursors(anchors, start);
 
     editor->emit_event("document::after-remove", this->shared_from_this(), start, end - start);
 }
@@ -111,11 +353,22 @@ void Document::clear() {
     auto editor = Editor::instance();
     editor->emit_event("document::before-clear", this->shared_from_this());
 
+    const auto anchors = this->anchor_cursors();
+
+    this->changes_.record(0, this->data_.size(), 0);
     this->data_.clear();
-    this->text_properties_.clear(sol::nullopt);
+    this->mapped_file_.reset();
+    this->text_properties_.clear(std::nullopt);
+    this->markers_.clear();
     this->modified_ = true;
+    // Discard the remainder of a file still being loaded.
+    if (this->loading_) {
+        this->loading_ = false;
+        this->load_generation_ += 1;
+    }
 
-    this->build_line_indices();
+    this->line_index_.clear();
+    this->restore_cursors(anchors, std::nullopt);
 
     editor->emit_event("document::after-clear", this->shared_from_this());
 }
@@ -124,53 +377,145 @@ void Document::replace(const std::size_t start, const std::size_t end, const std
     ASSERT(start <= end, "");
     ASSERT(end <= this->data_.size(), "");
 
+    if (!this->editable()) { return; }
+
     this->remove(start, end);
     this->insert(start, new_data);
     this->modified_ = true;
 }
 
-auto Document::line(std::size_t nth) const -> std::string_view {
+void Document::apply_edits(std::vector<Edit> edits) {
+    if (edits.empty()) { return; }
+
+    const auto start = edits.front().start_;
+    const auto end = edits.back().end_;
+    ASSERT(end <= this->data_.size(), "");
+
+    if (!this->editable()) { return; }
+
+    auto editor = Editor::instance();
+    editor->emit_event("document::before-edit", this->shared_from_this(), start, end - start);
+
+    // Collect the new contents of the edited range for the line index. Views into the current data stay valid after
+    // applying the edits, as the PieceTable never frees its buffers.
+    std::vector<std::string_view> chunks{};
+    auto pos = start;
+    auto len{0UZ};
+    for (const auto& edit: edits) {
+        ASSERT(pos <= edit.start_ && edit.start_ <= edit.end_, "edits must be sorted and must not overlap");
+
+        this->data_.for_each_chunk(pos, edit.start_, [&](const std::string_view chunk) -> void {
+            chunks.push_back(chunk);
+        });
+        chunks.emplace_back(edit.text_);
+
+        len += (edit.start_ - pos) + edit.text_.size();
+        pos = edit.end_;
+    }
+
+    // The inverse edits are positioned in the data after applying the edits.
+    const auto record = this->recording_transaction_ && !this->applying_transaction_;
+    std::vector<Edit> inverse{};
+    if (record) {
+        inverse.reserve(edits.size());
+
+        auto delta{0Z};
+        for (const auto& edit: edits) {
+            const auto inverse_start = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(edit.start_) + delta);
+            inverse.push_back(
+                Edit{
+                    .start_ = inverse_start,
+                    .end_ = inverse_start + edit.text_.size(),
+                    .text_ = this->data_.copy(edit.start_, edit.end_)});
+
+            delta += static_cast<std::ptrdiff_t>(edit.text_.size());
+            delta -= static_cast<std::ptrdiff_t>(edit.end_ - edit.start_);
+        }
+    }
+
+    const auto anchors = this->anchor_cursors();
+
+    this->data_.apply_edits(edits);
+    this->text_properties_.update_on_edits(edits);
+    this->markers_.update_on_edits(edits);
+    this->changes_.record_edits(edits);
+    this->modified_ = true;
+
+    this->line_index_.replace(start, end, chunks);
+    this->restore_cursors(anchors, std::nullopt);
+
+    if (record) { this->active_transaction_.record_edits(start, edits, inverse); }
+
+    editor->emit_event("document::after-edit", this->shared_from_this(), start, end - start, len);
+}
+
+auto Document::create_marker(const std::size_t pos, const Gravity gravity) -> std::shared_ptr<Marker> {
+    ASSERT(pos <= this->data_.size(), "");
+
+    return this->markers_.create(pos, gravity);
+}
+
+auto Document::line(std::size_t nth) const -> std::string {
     ASSERT(nth < this->line_count(), "");
 
-    const auto start = this->line_indices_[nth];
+    return this->data_.copy(this->line_begin_byte(nth), this->line_end_byte(nth));
+}
 
-    auto count = std::string::npos;
-    if (nth + 1 < this->line_indices_.size()) { count = this->line_indices_[nth + 1] - start; }
+auto Document::slice(const std::size_t start, const std::size_t end) const -> std::string {
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->data_.size(), "");
 
-    return std::string_view{this->data_}.substr(start, count);
+    return this->data_.copy(start, end);
 }
 
-auto Document::slice(const std::size_t start, const std::size_t end) const -> std::string_view {
+auto Document::slice(const std::size_t start, const std::size_t end, std::string& buffer) const -> std::string_view {
     ASSERT(start <= end, "");
     ASSERT(end <= this->data_.size(), "");
 
-    return std::string_view{this->data_.data() + start, end - start};
+    if (const auto view = this->data_.contiguous(start, end); view) { return *view; }
+
+    buffer.clear();
+    this->data_.for_each_chunk(start, end, [&](const std::string_view chunk) -> void { buffer.append(chunk); });
+
+    return buffer;
+}
+
+auto Document::at(const std::size_t pos) const -> char {
+    ASSERT(pos < this->data_.size(), "");
+
+    return this->data_.at(pos);
 }
 
 auto Document::line_begin_byte(const std::size_t nth) const -> std::size_t {
     ASSERT(nth < this->line_count(), "");
-    return this->line_indices_[nth];
+    return this->line_index_.line_begin_byte(nth);
 }
 
 auto Document::line_end_byte(const std::size_t nth) const -> std::size_t {
     ASSERT(nth < this->line_count(), "");
-
-    if (nth + 1 < this->line_indices_.size()) { return this->line_indices_[nth + 1]; }
-    return this->data_.size();
+    return this->line_index_.line_end_byte(nth);
 }
 
 auto Document::position_from_byte(const std::size_t byte) const -> Position {
-    auto row = std::distance(this->line_indices_.begin(), std::ranges::upper_bound(this->line_indices_, byte) - 1);
-    auto col = byte - this->line_indices_[row];
-    return Position{.row_ = static_cast<std::size_t>(row), .col_ = col};
+    return this->line_index_.position_from_byte(byte);
 }
 
 auto Document::search(const Regex& regex, const std::size_t start, const std::size_t end) const
     -> std::vector<RegexMatch> {
-    ASSERT(start < this->data_.length(), "");
+    ASSERT(start < this->data_.size(), "");
 
-    auto matches = regex.search(
-        std::string_view{this->data_.data() + start, math::sub_sat(std::min(this->data_.length(), end), start)});
+    const auto stop = std::max(start, std::min(this->data_.size(), end));
+
+    // The Regex requires contiguous data. Copy the range if it spans multiple pieces instead of coalescing them, as
+    // searches can cover the entire Document.
+    std::string buffer{};
+    auto text = this->data_.contiguous(start, stop);
+    if (!text) {
+        buffer = this->data_.copy(start, stop);
+        text = buffer;
+    }
+
+    auto matches = regex.search(*text);
 
     // Adjust the matches to have correct byte offsets, since the match indices are relative to the (shifted) input.
     for (auto& match: matches) {
@@ -181,11 +526,38 @@ auto Document::search(const Regex& regex, const std::size_t start, const std::si
     return matches;
 }
 
+auto Document::replace_all(
+    const Regex& regex, const std::string_view tmpl, const std::size_t start, const std::size_t end) -> std::size_t {
+    if (!this->editable() || start >= this->data_.size()) { return 0; }
+
+    const auto stop = std::min(this->data_.size(), end);
+    if (start >= stop) { return 0; }
+
+    // See Document::search.
+    std::string buffer{};
+    auto text = this->data_.contiguous(start, stop);
+    if (!text) {
+        buffer = this->data_.copy(start, stop);
+        text = buffer;
+    }
+
+    auto edits = regex.replace(*text, tmpl);
+    for (auto& edit: edits) {
+        edit.start_ += start;
+        edit.end_ += start;
+    }
+
+    const auto count = edits.size();
+    this->apply_edits(std::move(edits));
+
+    return count;
+}
+
 void Document::begin_transaction(std::size_t point) {
     if (this->recording_transaction_) { return; }
 
     this->recording_transaction_ = true;
-    this->active_transaction_.operations_.clear();
+    this->active_transaction_ = {};
     this->active_transaction_.point_before_ = point;
 }
 
@@ -196,9 +568,16 @@ void Document::end_transaction(std::size_t point) {
     if (this->active_transaction_.operations_.empty()) { return; }
 
     this->active_transaction_.point_after_ = point;
-    this->undo_stack_.push_back(std::move(this->active_transaction_));
+    this->active_transaction_.finish();
+
+    for (const auto& group: this->redo_stack_) { this->history_size_ -= group.size_; }
     this->redo_stack_.clear();
+
+    this->history_size_ += this->active_transaction_.size_;
+    this->undo_stack_.push_back(std::move(this->active_transaction_));
     this->active_transaction_ = {};
+
+    this->trim_history();
 }
 
 auto Document::undo() -> std::optional<std::size_t> {
@@ -209,10 +588,12 @@ auto Document::undo() -> std::optional<std::size_t> {
     this->undo_stack_.pop_back();
 
     for (const auto& operation: std::views::reverse(group.operations_)) {
-        if (operation.type_ == Operation::Type::INSERT) {
-            this->remove(operation.pos_, operation.pos_ + operation.data_.size());
-        } else {
-            this->insert(operation.pos_, operation.data_);
+        switch (operation.type_) {
+            case Operation::Type::INSERT:
+                this->remove(operation.pos_, operation.pos_ + operation.len_);
+                break;
+            case Operation::Type::REMOVE: this->insert(operation.pos_, group.text(operation)); break;
+            case Operation::Type::EDITS: this->apply_edits(group.edits(operation, true)); break;
         }
     }
 
@@ -231,10 +612,10 @@ auto Document::redo() -> std::optional<std::size_t> {
     this->redo_stack_.pop_back();
 
     for (const auto& op: group.operations_) {
-        if (op.type_ == Operation::Type::INSERT) {
-            this->insert(op.pos_, op.data_);
-        } else {
-            this->remove(op.pos_, op.pos_ + op.data_.size());
+        switch (op.type_) {
+            case Operation::Type::INSERT: this->insert(op.pos_, group.text(op)); break;
+            case Operation::Type::REMOVE: this->remove(op.pos_, op.pos_ + op.len_); break;
+            case Operation::Type::EDITS: this->apply_edits(group.edits(op, false)); break;
         }
     }
 
@@ -245,28 +626,43 @@ auto Document::redo() -> std::optional<std::size_t> {
     return point;
 }
 
+auto Document::undo_limit() const -> std::size_t { return this->undo_limit_; }
+
+void Document::set_undo_limit(const std::size_t limit) {
+    this->undo_limit_ = limit;
+    this->trim_history();
+}
+
 void Document::add_text_property(
-    const std::size_t start, const std::size_t end, const std::string& key, sol::object value) {
+    const std::size_t start, const std::size_t end, const Atom key, PropertyValue value) {
     ASSERT(start <= end, "");
     ASSERT(end <= this->data_.size(), "");
 
     this->text_properties_.add(start, end, key, std::move(value));
 }
 
-void Document::remove_text_property(const std::size_t start, const std::size_t end, const std::string_view key) {
+void Document::add_text_properties(const Atom key, std::vector<Property> props) {
+    for (const auto& prop: props) { ASSERT(prop.end_ <= this->data_.size(), ""); }
+
+    this->text_properties_.add_all(key, std::move(props));
+}
+
+void Document::remove_text_property(const std::size_t start, const std::size_t end, const Atom key) {
     ASSERT(start <= end, "");
     ASSERT(end <= this->data_.size(), "");
 
     this->text_properties_.remove(start, end, key);
 }
 
-void Document::clear_text_properties(const sol::optional<std::string>& key) { this->text_properties_.clear(key); }
-void Document::optimize_text_properties(const std::string_view key) { this->text_properties_.merge(key); }
+void Document::clear_text_properties(const std::optional<Atom> key) { this->text_properties_.clear(key); }
+void Document::optimize_text_properties(const Atom key) { this->text_properties_.merge(key); }
+void Document::begin_text_property_generation(const Atom key) { this->text_properties_.begin_generation(key); }
+void Document::end_text_property_generation(const Atom key) { this->text_properties_.end_generation(key); }
 
-auto Document::get_text_property(const std::size_t pos, const std::string_view key) const -> sol::object {
+auto Document::get_text_property(const std::size_t pos, const Atom key, sol::state& lua) const -> sol::object {
     ASSERT(pos <= this->data_.size(), "");
 
-    return this->text_properties_.get_property(pos, key);
+    return this->text_properties_.get_property(pos, key, lua);
 }
 
 auto Document::get_text_properties(const std::size_t pos, sol::state& lua) const -> sol::table {
@@ -275,48 +671,94 @@ auto Document::get_text_properties(const std::size_t pos, sol::state& lua) const
     return this->text_properties_.get_properties(pos, lua);
 }
 
-auto Document::get_all_text_properties(const std::string_view key, sol::state& lua) const -> sol::table {
+auto Document::get_all_text_properties(const Atom key, sol::state& lua) const -> sol::table {
     return this->text_properties_.get_all_properties(key, lua);
 }
 
-auto Document::get_raw_text_property(const std::size_t pos, const std::string_view key) const -> const Property* {
+auto Document::get_text_properties_in_range(
+    const std::size_t start, const std::size_t end, const std::optional<Atom> key, sol::state& lua) const
+    -> sol::table {
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->data_.size(), "");
+
+    return this->text_properties_.get_properties_in_range(start, end, key, lua);
+}
+
+auto Document::get_raw_text_property(const std::size_t pos, const Atom key) const -> const Property* {
     ASSERT(pos <= this->data_.size(), "");
 
     return this->text_properties_.get_raw_property(pos, key);
 }
 
-void Document::build_line_indices() {
-    this->line_indices_.clear();
-    this->line_indices_.emplace_back(0);
-
-    for (auto idx{0UZ}; idx < this->data_.size(); idx += 1) {
-        if (this->data_[idx] == '\n') { this->line_indices_.emplace_back(idx + 1); }
+auto Document::editable() const -> bool {
+    // The remainder of the file is appended behind the loaded data, edits would end up in front of it.
+    if (this->loading_) {
+        Editor::instance()->set_status_message("The file is still loading.", "info_message");
+        return false;
     }
+
+    return true;
 }
 
-void Document::update_line_indices_on_insert(const std::size_t pos, const std::string_view data) {
-    auto start = std::ranges::upper_bound(this->line_indices_, pos);
+void Document::finish_loading() {
+    this->loading_ = false;
 
-    // Shift subsequent line starts by the inserted length.
-    for (auto elem = start; elem != this->line_indices_.end(); elem++) { *elem += data.size(); }
+    auto editor = Editor::instance();
+    editor->emit_event("document::after-file-load", this->shared_from_this());
+    editor->request_render();
+}
 
-    // Insert lines from the inserted text.
-    if (data.contains('\n')) {
-        std::vector<std::size_t> add;
-        for (auto idx{0UZ}; idx < data.size(); idx += 1) {
-            if (data[idx] == '\n') { add.push_back(pos + idx + 1); }
-        }
+void Document::append_indexed(const std::string_view data, std::shared_ptr<const void> owner, LineIndex index) {
+    auto editor = Editor::instance();
+
+    const auto pos = this->data_.size();
+    editor->emit_event("document::before-insert", this->shared_from_this(), pos, data.size());
+
+    const auto anchors = this->anchor_cursors();
 
-        this->line_indices_.insert(start, add.begin(), add.end());
+    if (owner) {
+        this->data_.insert_external(pos, data, std::move(owner));
+    } else {
+        this->data_.insert(pos, data);
     }
+    this->text_properties_.update_on_insert(pos, data.size());
+    this->markers_.update_on_insert(pos, data.size());
+    this->changes_.record(pos, 0, data.size());
+    this->line_index_.append(std::move(index));
+
+    this->restore_cursors(anchors, pos);
+
+    editor->emit_event("document::after-insert", this->shared_from_this(), pos, data.size());
 }
 
-void Document::update_line_indices_on_remove(const std::size_t start, const std::size_t end) {
-    const auto len = end - start;
+auto Document::anchor_cursors() -> std::vector<std::size_t> {
+    std::vector<std::size_t> anchors{};
+    anchors.reserve(this->views_.size());
+    for (const auto& weak: this->views_) {
+        auto& anchor = anchors.emplace_back(0);
+        if (const auto view = weak.lock(); view) {
+            anchor = view->cur_.point(*view);
+            view->cur_marker_->pos_ = anchor;
+        }
+    }
 
-    auto it = this->line_indices_.erase(
-        std::ranges::upper_bound(this->line_indices_, start), std::ranges::upper_bound(this->line_indices_, end));
+    return anchors;
+}
 
-    // Shift subsequent line starts by the deleted length.
-    for (; it != this->line_indices_.end(); it++) { *it -= len; }
+void Document::restore_cursors(const std::vector<std::size_t>& anchors, const std::optional<std::size_t> start) {
+    ASSERT(anchors.size() == this->views_.size(), "");
+
+    for (auto idx{0UZ}; idx < anchors.size(); idx += 1) {
+        // A single edit starting at or behind a Cursor leaves its line and column unchanged.
+        if (start && *start >= anchors[idx]) { continue; }
+
+        if (const auto view = this->views_[idx].lock(); view) { view->cur_.point(*view, view->cur_marker_->pos_); }
+    }
+}
+
+void Document::trim_history() {
+    while (this->history_size_ > this->undo_limit_ && this->undo_stack_.size() > 1) {
+        this->history_size_ -= this->undo_stack_.front().size_;
+        this->undo_stack_.pop_front();
+    }
 }
@@ -1,23 +1,35 @@
 #ifndef BUFFER_HPP_
 #define BUFFER_HPP_
 
+#include <deque>
 #include <filesystem>
 #include <optional>
 #include <vector>
 
 #include <sol/table.hpp>
 
+#include "container/change_log.hpp"
+#include "container/line_index.hpp"
+#include "container/marker_list.hpp"
+#include "container/piece_table.hpp"
 #include "container/property_map.hpp"
+#include "types/atom.hpp"
+#include "types/edit.hpp"
 #include "types/transaction.hpp"
 #include "util/instance_tracker.hpp"
 
 struct DocumentBinding;
+struct DocumentSnapshot;
 struct DocumentView;
 struct FaceCache;
 struct Regex;
 struct RegexMatch;
 struct Position;
 
+namespace fs {
+    struct MappedFile;
+} // namespace fs
+
 /// Documents serve as the central abstraction of data.
 ///
 /// Data accesses should be done by the API of this class, if possible. Besides fetching lines, all position parameters
@@ -34,10 +46,14 @@ public:
     sol::table properties_;
     /// Properties bound to text ranges.
     PropertyMap text_properties_{};
+    /// Positions kept in sync with edits.
+    MarkerList markers_{};
+    /// Latest Changes of the data.
+    ChangeLog changes_{};
 
     bool modified_{false};
 
-    std::vector<Transaction> undo_stack_{};
+    std::deque<Transaction> undo_stack_{};
     std::vector<Transaction> redo_stack_{};
     Transaction active_transaction_{};
     bool recording_transaction_{false};
@@ -46,11 +62,32 @@ public:
     std::vector<std::weak_ptr<DocumentView>> views_;
 
 private:
-    // TODO: replace std::string with a more performant structure (PieceTable, Rope).
+    /// Files at least this large are mapped into memory instead of being read. Truncating a mapped file from outside
+    /// the editor loses the truncated part, it reads as zeros afterwards and saving is refused. Saving always replaces
+    /// the file instead of rewriting it, and files likely to be truncated are read instead (see fs::map_file).
+    static constexpr std::size_t MAP_THRESHOLD{16UZ * 1024UZ * 1024UZ};
+    /// Bytes of a mapped file that are indexed and shown first. The rest is indexed afterwards.
+    static constexpr std::size_t INDEX_CHUNK_SIZE{4UZ * 1024UZ * 1024UZ};
+
+    /// Set while the backing file is being loaded in the background.
+    bool loading_{false};
+    /// Incremented whenever a background load is discarded, identifying outdated results.
+    std::size_t load_generation_{0};
+    /// Set while the data is being written on a worker thread.
+    bool saving_{false};
+    /// Mapping of the loaded file, if it was mapped.
+    std::weak_ptr<const fs::MappedFile> mapped_file_{};
+
+    /// Maximum memory used by the undo and redo history. The oldest Transactions are dropped once it is exceeded, the
+    /// latest Transaction is always kept.
+    std::size_t undo_limit_{64UZ * 1024UZ * 1024UZ};
+    /// Memory used by the undo and redo history.
+    std::size_t history_size_{0};
+
     /// Document data.
-    std::string data_{};
-    /// Starting indices of lines.
-    std::vector<std::size_t> line_indices_{};
+    PieceTable data_{};
+    /// Line lengths of the data.
+    LineIndex line_index_{};
 
 public:
     Document(std::optional<std::filesystem::path> path, sol::state& lua);
@@ -63,17 +100,41 @@ public:
     [[nodiscard]]
     auto views() -> std::vector<std::shared_ptr<DocumentView>>;
 
-    /// Writes the contents to the underlying or new path.
+    /// Appends the contents of the backing file, reading and indexing it on a worker thread. Large files are mapped
+    /// into memory instead of being copied, edits never modify the mapping. Only their first chunk is appended once
+    /// indexed, the rest is indexed and appended afterwards. "document::after-file-load" is emitted once done.
+    void load();
+    /// Writes a snapshot of the contents to the underlying or new path on a worker thread. The file is replaced
+    /// atomically once the snapshot was written completely.
     void save(std::optional<std::filesystem::path> path);
 
+    /// Checks if the data references a memory mapped file.
+    [[nodiscard]]
+    auto mapped() const -> bool;
+    /// Checks if the backing file is still being loaded.
+    [[nodiscard]]
+    auto loading() const -> bool;
+    /// Checks if the contents are still being saved.
+    [[nodiscard]]
+    auto saving() const -> bool;
+
     /// Gets the number of lines of the document.
     [[nodiscard]]
     auto line_count() const -> std::size_t;
     /// Gets the size of the document.
     [[nodiscard]]
     auto size() const -> std::size_t;
+    /// Gets the revision of the data, which is incremented by every Change.
+    [[nodiscard]]
+    auto revision() const -> std::size_t;
+    /// Gets the Changes since a revision in order, or nothing if they are too old to be recorded anymore.
+    [[nodiscard]]
+    auto changes_since(std::size_t revision) const -> std::optional<std::vector<Change>>;
+    /// Takes an immutable snapshot of the data at the current revision, which may be read on other threads.
+    [[nodiscard]]
+    auto snapshot() const -> std::shared_ptr<const DocumentSnapshot>;
 
-    /// Inserts data into the document at pos.
+    /// Inserts data into the document at pos. Edits are rejected while the backing file is being loaded.
     void insert(std::size_t pos, std::string_view data);
     /// Removes data from start to end from the document.
     void remove(std::size_t start, std::size_t end);
@@ -81,13 +142,33 @@ public:
     void clear();
     /// Replaces data from start to end with new_data.
     void replace(std::size_t start, std::size_t end, std::string_view new_data);
+    /// Applies sorted, non-overlapping edits in a single pass. Emits one aggregated edit event spanning from the start
+    /// of the first to the end of the last edit and records a single operation.
+    void apply_edits(std::vector<Edit> edits);
 
-    /// Gets the nth line of the document.
+    /// Creates a Marker at pos that moves with edits for as long as it is referenced.
     [[nodiscard]]
-    auto line(std::size_t nth) const -> std::string_view;
-    /// Gets a slice of data from start point to end point.
+    auto create_marker(std::size_t pos, Gravity gravity = Gravity::LEFT) -> std::shared_ptr<Marker>;
+
+    /// Copies the nth line of the document.
+    [[nodiscard]]
+    auto line(std::size_t nth) const -> std::string;
+    /// Copies a slice of data from start point to end point.
+    [[nodiscard]]
+    auto slice(std::size_t start, std::size_t end) const -> std::string;
+    /// Gets a view of the data from start point to end point. The data is only copied into buffer if it is not stored
+    /// contiguously. The view stays valid until the document is edited or buffer is modified.
     [[nodiscard]]
-    auto slice(std::size_t start, std::size_t end) const -> std::string_view;
+    auto slice(std::size_t start, std::size_t end, std::string& buffer) const -> std::string_view;
+    /// Gets the byte at pos.
+    [[nodiscard]]
+    auto at(std::size_t pos) const -> char;
+    /// Calls fn with every contiguous chunk of data from start point to end point. Prefer this over Document::slice
+    /// for large ranges, as it never copies the data.
+    template<typename Fn>
+    void for_each_chunk(const std::size_t start, const std::size_t end, Fn&& fn) const {
+        this->data_.for_each_chunk(start, end, std::forward<Fn>(fn));
+    }
 
     /// Gets the byte beginning the nth line of the document.
     [[nodiscard]]
@@ -105,6 +186,13 @@ public:
     search(const Regex& regex, std::size_t start = 0, std::size_t end = std::numeric_limits<std::size_t>::max()) const
         -> std::vector<RegexMatch>;
 
+    /// Replaces all matches of a Regex pattern in a given range (defaults to the entire Document) with the expanded
+    /// template (see Regex::replace) as a single batch of edits. Returns the count of replaced matches, zero if the
+    /// Document cannot be edited yet.
+    auto replace_all(
+        const Regex& regex, std::string_view tmpl, std::size_t start = 0,
+        std::size_t end = std::numeric_limits<std::size_t>::max()) -> std::size_t;
+
     void begin_transaction(std::size_t point);
     void end_transaction(std::size_t point);
     /// Undos the last transaction, returing the position of the cursor after undoing.
@@ -113,29 +201,60 @@ public:
     /// Redos the last undone transaction, return the position of the cursor after redoing.
     [[nodiscard]]
     auto redo() -> std::optional<std::size_t>;
+    [[nodiscard]]
+    auto undo_limit() const -> std::size_t;
+    /// Sets the maximum memory used by the undo and redo history, dropping the oldest Transactions if it is exceeded.
+    void set_undo_limit(std::size_t limit);
 
     /// Add or update a property on a text range.
-    void add_text_property(std::size_t start, std::size_t end, const std::string& key, sol::object value);
+    void add_text_property(std::size_t start, std::size_t end, Atom key, PropertyValue value);
+    /// Add or update properties on multiple text ranges. Later properties replace earlier ones where they overlap.
+    void add_text_properties(Atom key, std::vector<Property> props);
     /// Remove all matching properties in the given range.
-    void remove_text_property(std::size_t start, std::size_t end, std::string_view key);
+    void remove_text_property(std::size_t start, std::size_t end, Atom key);
     /// Remove all or matching properties.
-    void clear_text_properties(const sol::optional<std::string>& key = sol::nullopt);
+    void clear_text_properties(std::optional<Atom> key = std::nullopt);
     /// Optimizes properties by merging overlapping properties.
-    void optimize_text_properties(std::string_view key);
+    void optimize_text_properties(Atom key);
+    /// Starts a new generation of matching text properties. Properties not added again before the generation ends
+    /// are removed.
+    void begin_text_property_generation(Atom key);
+    /// Ends the current generation of matching text properties, removing all stale ones.
+    void end_text_property_generation(Atom key);
 
     [[nodiscard]]
-    auto get_text_property(std::size_t pos, std::string_view key) const -> sol::object;
+    auto get_text_property(std::size_t pos, Atom key, sol::state& lua) const -> sol::object;
     [[nodiscard]]
     auto get_text_properties(std::size_t pos, sol::state& lua) const -> sol::table;
     [[nodiscard]]
-    auto get_all_text_properties(std::string_view key, sol::state& lua) const -> sol::table;
+    auto get_all_text_properties(Atom key, sol::state& lua) const -> sol::table;
     [[nodiscard]]
-    auto get_raw_text_property(std::size_t pos, std::string_view key) const -> const Property*;
+    auto get_text_properties_in_range(
+        std::size_t start, std::size_t end, std::optional<Atom> key, sol::state& lua) const -> sol::table;
+    [[nodiscard]]
+    auto get_raw_text_property(std::size_t pos, Atom key) const -> const Property*;
 
 private:
-    void build_line_indices();
-    void update_line_indices_on_insert(std::size_t pos, std::string_view data);
-    void update_line_indices_on_remove(std::size_t start, std::size_t end);
+    /// Indexes data on a worker thread and appends it once done. data must stay valid as long as owner is alive.
+    void index_in_background(std::shared_ptr<const void> owner, std::string_view data);
+    /// Checks if the data may be edited, reporting the reason to the user otherwise.
+    [[nodiscard]]
+    auto editable() const -> bool;
+    /// Ends loading the backing file.
+    void finish_loading();
+    /// Appends data using a prebuilt index of it. If an owner is given, data is referenced without copying it and must
+    /// stay valid as long as owner is alive.
+    void append_indexed(std::string_view data, std::shared_ptr<const void> owner, LineIndex index);
+
+    /// Anchors the Cursors of all views at their points before an edit, returning the points.
+    [[nodiscard]]
+    auto anchor_cursors() -> std::vector<std::size_t>;
+    /// Moves the Cursors of all views to their anchors after an edit. If the edit was a single insertion or removal
+    /// starting at start, Cursors at or before start are skipped. Cursors are always moved if start is not given.
+    void restore_cursors(const std::vector<std::size_t>& anchors, std::optional<std::size_t> start);
+
+    /// Drops the oldest undoable Transactions until the history fits into the undo limit.
+    void trim_history();
 };
 
 #endif
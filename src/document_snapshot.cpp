@@ -0,0 +1,36 @@
+#include "document_snapshot.hpp"
+
+#include "util/assert.hpp"
+
+DocumentSnapshot::DocumentSnapshot(const std::size_t revision, PieceTable data, LineIndex line_index)
+    : revision_{revision}, data_{std::move(data)}, line_index_{std::move(line_index)} {}
+
+auto DocumentSnapshot::size() const -> std::size_t { return this->data_.size(); }
+auto DocumentSnapshot::line_count() const -> std::size_t { return this->line_index_.line_count(); }
+
+auto DocumentSnapshot::copy(const std::size_t start, const std::size_t end) const -> std::string {
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->data_.size(), "");
+
+    return this->data_.copy(start, end);
+}
+
+auto DocumentSnapshot::line(const std::size_t nth) const -> std::string {
+    ASSERT(nth < this->line_count(), "");
+
+    return this->data_.copy(this->line_index_.line_begin_byte(nth), this->line_index_.line_end_byte(nth));
+}
+
+auto DocumentSnapshot::line_begin_byte(const std::size_t nth) const -> std::size_t {
+    ASSERT(nth < this->line_count(), "");
+    return this->line_index_.line_begin_byte(nth);
+}
+
+auto DocumentSnapshot::line_end_byte(const std::size_t nth) const -> std::size_t {
+    ASSERT(nth < this->line_count(), "");
+    return this->line_index_.line_end_byte(nth);
+}
+
+auto DocumentSnapshot::position_from_byte(const std::size_t byte) const -> Position {
+    return this->line_index_.position_from_byte(byte);
+}
@@ -0,0 +1,62 @@
+#ifndef DOCUMENT_SNAPSHOT_HPP_
+#define DOCUMENT_SNAPSHOT_HPP_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "container/line_index.hpp"
+#include "container/piece_table.hpp"
+#include "types/position.hpp"
+
+/// DocumentSnapshots are immutable views of the data of a Document at a revision. They share all unchanged data with
+/// the Document instead of copying it, making them cheap to create.
+///
+/// Unlike a Document, a DocumentSnapshot may be read on any thread while the Document keeps being edited.
+struct DocumentSnapshot {
+public:
+    /// Revision of the Document the snapshot was taken at.
+    std::size_t revision_;
+
+private:
+    PieceTable data_;
+    LineIndex line_index_;
+
+public:
+    DocumentSnapshot(std::size_t revision, PieceTable data, LineIndex line_index);
+
+    DocumentSnapshot(const DocumentSnapshot&) = delete;
+    auto operator=(const DocumentSnapshot&) -> DocumentSnapshot& = delete;
+    DocumentSnapshot(DocumentSnapshot&&) noexcept = default;
+    auto operator=(DocumentSnapshot&&) noexcept -> DocumentSnapshot& = default;
+
+    [[nodiscard]]
+    auto size() const -> std::size_t;
+    [[nodiscard]]
+    auto line_count() const -> std::size_t;
+
+    /// Copies the data from start to end.
+    [[nodiscard]]
+    auto copy(std::size_t start, std::size_t end) const -> std::string;
+    /// Copies the nth line. This includes the newline character.
+    [[nodiscard]]
+    auto line(std::size_t nth) const -> std::string;
+
+    /// Gets the byte beginning the nth line.
+    [[nodiscard]]
+    auto line_begin_byte(std::size_t nth) const -> std::size_t;
+    /// Gets the byte one after the end of the nth line. This includes the newline character.
+    [[nodiscard]]
+    auto line_end_byte(std::size_t nth) const -> std::size_t;
+    /// Gets the position struct from a byte offset.
+    [[nodiscard]]
+    auto position_from_byte(std::size_t byte) const -> Position;
+
+    /// Calls fn with every contiguous chunk of data from start to end in order.
+    template<typename Fn>
+    void for_each_chunk(const std::size_t start, const std::size_t end, Fn&& fn) const {
+        this->data_.for_each_chunk(start, end, std::forward<Fn>(fn));
+    }
+};
+
+#endif
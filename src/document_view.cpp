@@ -10,6 +10,8 @@
 DocumentView::DocumentView(std::shared_ptr<Document> doc, sol::state& lua)
     : doc_{std::move(doc)}, properties_{lua.create_table()} {
     ASSERT(this->doc_, "DocumentView must be initialized with a valid Document");
+
+    this->cur_marker_ = this->doc_->create_marker(0, Gravity::LEFT);
 }
 
 auto DocumentView::move_cursor(const cursor::move_fn& move_fn, const std::size_t n) -> bool {
@@ -35,27 +37,50 @@ void DocumentView::reset_cursor() {
 }
 
 void DocumentView::add_view_property(
-    const std::size_t start, const std::size_t end, const std::string& key, sol::object value) {
+    const std::size_t start, const std::size_t end, const Atom key, PropertyValue value) {
     ASSERT(start <= end, "");
     ASSERT(end <= this->doc_->size(), "");
 
+    if (key == atoms::REPLACEMENT) { this->replacements_revision_ += 1; }
     this->view_properties_.add(start, end, key, std::move(value));
 }
 
-void DocumentView::remove_view_property(const std::size_t start, const std::size_t end, const std::string_view key) {
+void DocumentView::add_view_properties(const Atom key, std::vector<Property> props) {
+    for (const auto& prop: props) { ASSERT(prop.end_ <= this->doc_->size(), ""); }
+
+    if (key == atoms::REPLACEMENT) { this->replacements_revision_ += 1; }
+    this->view_properties_.add_all(key, std::move(props));
+}
+
+void DocumentView::remove_view_property(const std::size_t start, const std::size_t end, const Atom key) {
     ASSERT(start <= end, "");
     ASSERT(end <= this->doc_->size(), "");
 
+    if (key == atoms::REPLACEMENT) { this->replacements_revision_ += 1; }
     this->view_properties_.remove(start, end, key);
 }
 
-void DocumentView::clear_view_properties(const sol::optional<std::string>& key) { this->view_properties_.clear(key); }
-void DocumentView::optimize_view_properties(std::string_view key) { this->view_properties_.merge(key); }
+void DocumentView::clear_view_properties(const std::optional<Atom> key) {
+    if (!key || *key == atoms::REPLACEMENT) { this->replacements_revision_ += 1; }
+    this->view_properties_.clear(key);
+}
+
+void DocumentView::optimize_view_properties(const Atom key) {
+    if (key == atoms::REPLACEMENT) { this->replacements_revision_ += 1; }
+    this->view_properties_.merge(key);
+}
+
+void DocumentView::begin_view_property_generation(const Atom key) { this->view_properties_.begin_generation(key); }
 
-auto DocumentView::get_view_property(const std::size_t pos, const std::string_view key) const -> sol::object {
+void DocumentView::end_view_property_generation(const Atom key) {
+    if (key == atoms::REPLACEMENT) { this->replacements_revision_ += 1; }
+    this->view_properties_.end_generation(key);
+}
+
+auto DocumentView::get_view_property(const std::size_t pos, const Atom key, sol::state& lua) const -> sol::object {
     ASSERT(pos <= this->doc_->size(), "");
 
-    return this->view_properties_.get_property(pos, key);
+    return this->view_properties_.get_property(pos, key, lua);
 }
 
 auto DocumentView::get_view_properties(const std::size_t pos, sol::state& lua) const -> sol::table {
@@ -64,11 +89,20 @@ auto DocumentView::get_view_properties(const std::size_t pos, sol::state& lua) c
     return this->view_properties_.get_properties(pos, lua);
 }
 
-auto DocumentView::get_all_view_properties(const std::string_view key, sol::state& lua) const -> sol::table {
+auto DocumentView::get_all_view_properties(const Atom key, sol::state& lua) const -> sol::table {
     return this->view_properties_.get_all_properties(key, lua);
 }
 
-auto DocumentView::get_raw_view_property(const std::size_t pos, const std::string_view key) const -> const Property* {
+auto DocumentView::get_view_properties_in_range(
+    const std::size_t start, const std::size_t end, const std::optional<Atom> key, sol::state& lua) const
+    -> sol::table {
+    ASSERT(start <= end, "");
+    ASSERT(end <= this->doc_->size(), "");
+
+    return this->view_properties_.get_properties_in_range(start, end, key, lua);
+}
+
+auto DocumentView::get_raw_view_property(const std::size_t pos, const Atom key) const -> const Property* {
     ASSERT(pos <= this->doc_->size(), "");
 
     return this->view_properties_.get_raw_property(pos, key);
@@ -2,14 +2,19 @@
 #define DOCUMENT_VIEW_HPP_
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <sol/forward.hpp>
 #include <sol/table.hpp>
 
+#include "container/face_registry.hpp"
 #include "container/property_map.hpp"
 #include "cursor.hpp"
+#include "types/atom.hpp"
+#include "types/marker.hpp"
 #include "util/instance_tracker.hpp"
 
 struct Document;
@@ -21,9 +26,15 @@ public:
     std::shared_ptr<Document> doc_;
 
     Cursor cur_{};
+    /// Tracks the Cursor across edits of the Document.
+    std::shared_ptr<Marker> cur_marker_{};
 
     sol::table properties_;
     PropertyMap view_properties_{};
+    /// Incremented whenever replacement view properties are changed by other means than edits.
+    std::size_t replacements_revision_{0};
+    /// Faces resolved for this view by the FaceRegistry.
+    ResolvedFaces resolved_faces_{};
 
     /// Show gutter.
     bool gutter_{true};
@@ -46,22 +57,32 @@ public:
     void reset_cursor();
 
     /// Add or update a view property on a text range.
-    void add_view_property(std::size_t start, std::size_t end, const std::string& key, sol::object value);
+    void add_view_property(std::size_t start, std::size_t end, Atom key, PropertyValue value);
+    /// Add or update view properties on multiple text ranges. Later properties replace earlier ones where they overlap.
+    void add_view_properties(Atom key, std::vector<Property> props);
     /// Remove all matching view properties in the given range.
-    void remove_view_property(std::size_t start, std::size_t end, std::string_view key);
+    void remove_view_property(std::size_t start, std::size_t end, Atom key);
     /// Remove all or matching view properties.
-    void clear_view_properties(const sol::optional<std::string>& key = sol::nullopt);
+    void clear_view_properties(std::optional<Atom> key = std::nullopt);
     /// Optimizes view properties by merging overlapping properties.
-    void optimize_view_properties(std::string_view key);
+    void optimize_view_properties(Atom key);
+    /// Starts a new generation of matching view properties. Properties not added again before the generation ends
+    /// are removed.
+    void begin_view_property_generation(Atom key);
+    /// Ends the current generation of matching view properties, removing all stale ones.
+    void end_view_property_generation(Atom key);
 
     [[nodiscard]]
-    auto get_view_property(std::size_t pos, std::string_view key) const -> sol::object;
+    auto get_view_property(std::size_t pos, Atom key, sol::state& lua) const -> sol::object;
     [[nodiscard]]
     auto get_view_properties(std::size_t pos, sol::state& lua) const -> sol::table;
     [[nodiscard]]
-    auto get_all_view_properties(std::string_view key, sol::state& lua) const -> sol::table;
+    auto get_all_view_properties(Atom key, sol::state& lua) const -> sol::table;
     [[nodiscard]]
-    auto get_raw_view_property(std::size_t pos, std::string_view key) const -> const Property*;
+    auto get_view_properties_in_range(
+        std::size_t start, std::size_t end, std::optional<Atom> key, sol::state& lua) const -> sol::table;
+    [[nodiscard]]
+    auto get_raw_view_property(std::size_t pos, Atom key) const -> const Property*;
 
     [[nodiscard]]
     auto clone() const -> std::shared_ptr<DocumentView>;
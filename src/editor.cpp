@@ -1,5 +1,6 @@
 #include "editor.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <uv.h>
 
@@ -110,11 +111,7 @@ auto Editor::create_document(std::optional<std::filesystem::path> path) -> std::
 
     if (doc->path_) {
         this->emit_event("document::before-file-load", doc);
-        if (auto content = fs::read_file(*doc->path_)) {
-            doc->insert(0, *content);
-            doc->modified_ = false;
-        }
-        this->emit_event("document::after-file-load", doc);
+        doc->load();
     }
 
     this->emit_event("document::created", doc);
@@ -270,6 +267,11 @@ void Editor::set_status_message(std::string_view message, std::string_view mode,
 
 void Editor::request_render() { this->render(); }
 
+auto Editor::is_face_layer(const Atom key) const -> bool {
+    return std::ranges::any_of(
+        this->face_layers_, [&](const std::string& layer) -> bool { return layer == key.name(); });
+}
+
 void Editor::alloc_input(uv_handle_t* /* handle */, std::size_t /* recommendation */, uv_buf_t* buf) {
     // Large static input buffer to avoid memory allocation and frees.
     static std::array<char, 4096> input_buffer{};
@@ -295,7 +297,10 @@ void Editor::input(uv_stream_t* stream, const ssize_t nread, const uv_buf_t* buf
     auto consumed{0UZ};
     while (true) {
         const auto view = std::string_view{self->input_buff_.data() + consumed, self->input_buff_.size() - consumed};
-        if (auto [key, len] = Key::try_parse_ansi(view); key) { // Successful parse.
+        if (const auto len = self->parse_mode_report(view); len) { // Terminal report.
+            if (*len == 0) { break; }
+            consumed += *len;
+        } else if (auto [key, len] = Key::try_parse_ansi(view); key) { // Successful parse.
             consumed += len;
             self->process_key(*key);
         } else if (self->input_buff_.size() == 1 && self->input_buff_[0] == '\x1b') { // Lone Esc.
@@ -314,6 +319,21 @@ void Editor::input(uv_stream_t* stream, const ssize_t nread, const uv_buf_t* buf
     }
 }
 
+auto Editor::parse_mode_report(const std::string_view input) -> std::optional<std::size_t> {
+    // Report of the synchronized output mode queried on startup: CSI ? 2026 ; Ps $ y
+    constexpr std::string_view prefix{"\x1B[?2026;"};
+    if (!input.starts_with(prefix)) { return std::nullopt; }
+
+    const auto end = input.find("$y", prefix.size());
+    if (end == std::string_view::npos) { return 0; }
+
+    // The mode is supported if it is reported as set or reset.
+    const auto state = input.substr(prefix.size(), end - prefix.size());
+    this->display_.synchronize(state == "1" || state == "2");
+
+    return end + 2;
+}
+
 void Editor::resize(uv_signal_t* handle, const int code) {
     auto* self = static_cast<Editor*>(handle->data);
 
@@ -352,6 +372,17 @@ void Editor::status_message_timer(uv_timer_t* handle) {
     self->render();
 }
 
+void Editor::render_check(uv_check_t* handle) {
+    auto* self = static_cast<Editor*>(handle->data);
+    // Frames held back by the frame rate are rendered by the timer.
+    if (self->render_pending_ && self->frame_delay() == 0) { self->render_frame(); }
+}
+
+void Editor::render_timer(uv_timer_t* handle) {
+    auto* self = static_cast<Editor*>(handle->data);
+    self->render_frame();
+}
+
 auto Editor::init_uv() -> Editor& {
     uv_tty_init(this->loop_, &this->tty_in_, 0, 1);
     uv_tty_init(this->loop_, &this->tty_out_, 1, 0);
@@ -372,8 +403,14 @@ auto Editor::init_uv() -> Editor& {
 
     uv_timer_init(this->loop_, &this->esc_timer_);
     uv_timer_init(this->loop_, &this->status_message_timer_);
+    uv_timer_init(this->loop_, &this->render_timer_);
     this->esc_timer_.data = this;
     this->status_message_timer_.data = this;
+    this->render_timer_.data = this;
+
+    uv_check_init(this->loop_, &this->render_check_);
+    this->render_check_.data = this;
+    uv_check_start(&this->render_check_, &Editor::render_check);
 
     return *this;
 }
@@ -420,6 +457,7 @@ auto Editor::init_bridge() -> Editor& {
     auto core = this->lua_.create_named_table("Core");
 
     AsyncProcessBinding::init_bridge(core);
+    AtomBinding::init_bridge(core);
     CursorBinding::init_bridge(core);
     CursorStyleBinding::init_bridge(core);
     DirectionBinding::init_bridge(core);
@@ -428,6 +466,7 @@ auto Editor::init_bridge() -> Editor& {
     EditorBinding::init_bridge(this->lua_);
     FaceBinding::init_bridge(core);
     KeyBinding::init_bridge(core);
+    MarkerBinding::init_bridge(core);
     PositionBinding::init_bridge(core);
     RegexBinding::init_bridge(core);
     RegexMatchBinding::init_bridge(core);
@@ -444,7 +483,7 @@ auto Editor::init_bridge() -> Editor& {
 }
 
 auto Editor::init_state(CliParser cli) -> Editor& {
-    this->display_.ready_ = [this]() -> void { this->request_render(); };
+    this->display_.ready_ = [this]() -> void { this->schedule_render(); };
 
     this->cli_args_ = cli.options_;
 
@@ -505,11 +544,7 @@ auto Editor::init_state(CliParser cli) -> Editor& {
 
     if (doc->path_) {
         this->emit_event("document::before-file-load", doc);
-        if (auto content = fs::read_file(*doc->path_)) {
-            doc->insert(0, *content);
-            doc->modified_ = false;
-        }
-        this->emit_event("document::after-file-load", doc);
+        doc->load();
     }
     this->emit_event("document::created", doc);
 
@@ -550,6 +585,8 @@ void Editor::shutdown() {
 
     uv_close(reinterpret_cast<uv_handle_t*>(&this->esc_timer_), nullptr);
     uv_close(reinterpret_cast<uv_handle_t*>(&this->status_message_timer_), nullptr);
+    uv_close(reinterpret_cast<uv_handle_t*>(&this->render_timer_), nullptr);
+    uv_close(reinterpret_cast<uv_handle_t*>(&this->render_check_), nullptr);
 
     // Drain loop of handle close events.
     while (uv_loop_alive(this->loop_) != 0) { uv_run(this->loop_, UV_RUN_NOWAIT); }
@@ -588,9 +625,42 @@ void Editor::process_key(const Key key) {
 void Editor::render() {
     if (this->is_rendering_) {
         this->request_rendering_ = true;
-    } else {
-        this->_render();
+        return;
     }
+
+    // All requests until the frame is rendered are coalesced into it.
+    this->render_pending_ = true;
+    this->schedule_render();
+}
+
+void Editor::schedule_render() {
+    if (!this->render_pending_ || uv_is_active(reinterpret_cast<uv_handle_t*>(&this->render_timer_)) != 0) { return; }
+
+    // Frames without delay are rendered by the check handle at the end of the current loop iteration already, the
+    // timer only wakes up the loop for them if the request was made after it.
+    uv_timer_start(&this->render_timer_, &Editor::render_timer, this->frame_delay(), 0);
+}
+
+void Editor::render_frame() {
+    if (!this->render_pending_ || this->stop_) { return; }
+
+    uv_timer_stop(&this->render_timer_);
+
+    // The Display schedules the frame again once it has written the last one.
+    if (this->display_.writing()) { return; }
+
+    this->render_pending_ = false;
+    this->last_frame_ = uv_now(this->loop_);
+    this->_render();
+}
+
+auto Editor::frame_delay() const -> std::uint64_t {
+    if (this->max_fps_ == 0) { return 0; }
+
+    const auto interval = 1000 / this->max_fps_;
+    const auto elapsed = uv_now(this->loop_) - this->last_frame_;
+
+    return elapsed >= interval ? 0 : interval - elapsed;
 }
 
 void Editor::_render() {
@@ -598,10 +668,10 @@ void Editor::_render() {
 
     this->is_rendering_ = true;
 
-    sol::protected_function resolve_face = this->lua_["Core"]["Faces"]["resolve_face"];
     sol::protected_function resolve_cursor = this->lua_["Core"]["Modes"]["resolve_cursor_style"];
 
-    do {
+    auto rendered{false};
+    for (auto attempt{0UZ}; attempt < Editor::MAX_RENDER_ATTEMPTS; attempt += 1) {
         this->request_rendering_ = false;
 
         if (this->workspace_.active_viewport_) { this->workspace_.active_viewport_->adjust_viewport(); }
@@ -616,9 +686,14 @@ void Editor::_render() {
             this->workspace_.mini_buffer_.viewport_->width_, mini_buffer_height,
             Position{.row_ = height - mini_buffer_height, .col_ = 0});
 
-        if (!this->workspace_.render(this->display_, resolve_face)) { continue; }
-        if (!this->workspace_.mini_buffer_.viewport_->render(this->display_, resolve_face)) { continue; }
+        rendered = this->workspace_.render(this->display_, this->faces_) &&
+                   this->workspace_.mini_buffer_.viewport_->render(this->display_, this->faces_);
 
+        // Failed frames are only retried right away if something changed while rendering them.
+        if (rendered || !this->request_rendering_) { break; }
+    }
+
+    if (rendered) {
         if (this->workspace_.is_mini_buffer_) {
             this->workspace_.mini_buffer_.viewport_->render_cursor(
                 this->display_,
@@ -629,7 +704,13 @@ void Editor::_render() {
         }
 
         this->display_.render(&this->tty_out_);
-    } while (this->request_rendering_);
+    }
 
     this->is_rendering_ = false;
+
+    // Requests made while rendering get the next frame.
+    if (this->request_rendering_) {
+        this->request_rendering_ = false;
+        this->render();
+    }
 }
@@ -1,12 +1,14 @@
 #ifndef EDITOR_HPP_
 #define EDITOR_HPP_
 
+#include <cstdint>
 #include <filesystem>
 
 #include <memory>
 #include <sol/state.hpp>
 #include <uv.h>
 
+#include "container/face_registry.hpp"
 #include "container/mini_buffer.hpp"
 #include "render/display.hpp"
 #include "render/workspace.hpp"
@@ -34,6 +36,9 @@ struct Editor {
 private:
     struct EditorKey {};
 
+    /// Maximum attempts to render a frame whose rendering was interrupted by a new request.
+    static constexpr std::size_t MAX_RENDER_ATTEMPTS{3};
+
 public:
     /// Handle to the libuv loop.
     uv_loop_t* loop_;
@@ -46,6 +51,10 @@ public:
     sol::table cli_args_{};
     /// Face layers used (in order) during rendering.
     std::vector<std::string> face_layers_{};
+    /// Named Faces and the Faces resolved for DocumentViews.
+    FaceRegistry faces_{};
+    /// Maximum frames rendered per second, zero for no limit.
+    std::size_t max_fps_{60};
 
     std::vector<std::shared_ptr<Document>> documents_{};
     std::vector<std::shared_ptr<DocumentView>> document_views_{};
@@ -74,6 +83,15 @@ private:
     bool is_rendering_{true};
     bool request_rendering_{false};
 
+    /// A frame was requested but has not been rendered yet.
+    bool render_pending_{false};
+    /// Loop time the last frame was rendered at in milliseconds.
+    std::uint64_t last_frame_{0};
+    /// Renders pending frames at the end of a loop iteration, coalescing all requests made during it.
+    uv_check_t render_check_{};
+    /// Delays pending frames to keep the frame rate below max_fps_.
+    uv_timer_t render_timer_{};
+
     Display display_{};
 
 public:
@@ -122,6 +140,10 @@ public:
 
     void request_render();
 
+    /// Checks if properties of key name faces, i.e. if key is one of the face layers.
+    [[nodiscard]]
+    auto is_face_layer(Atom key) const -> bool;
+
     /// Emits an event triggering Lua hooks listening for it.
     template<typename... Args>
     void emit_event(const std::string_view event, Args&&... args) {
@@ -167,6 +189,10 @@ private:
     static void esc_timer(uv_timer_t* handle);
     /// Callback on when to clear a status message.
     static void status_message_timer(uv_timer_t* handle);
+    /// Callback at the end of every loop iteration to render pending frames.
+    static void render_check(uv_check_t* handle);
+    /// Callback on when a delayed frame is due.
+    static void render_timer(uv_timer_t* handle);
 
     /// Initializes the Lua runtime.
     auto init_lua() -> Editor&;
@@ -181,9 +207,20 @@ private:
 
     /// Processes the keypress.
     void process_key(Key key);
+    /// Handles a report of a terminal mode at the start of the input. Returns the length of the report, zero if it is
+    /// incomplete, or nothing if the input does not start with one.
+    [[nodiscard]]
+    auto parse_mode_report(std::string_view input) -> std::optional<std::size_t>;
 
     /// Schedules rendering of the editor to the display.
     void render();
+    /// Starts the timer for a pending frame unless it is already running.
+    void schedule_render();
+    /// Renders a pending frame if the Display is ready for it.
+    void render_frame();
+    /// Gets the milliseconds until the next frame may be rendered.
+    [[nodiscard]]
+    auto frame_delay() const -> std::uint64_t;
     /// Renders all Viewports.
     void _render();
 };
@@ -110,6 +110,7 @@ auto main(const int argc, char* argv[]) -> int {
     std::string s{};
     ansi::alt_screen(s);
     ansi::enable_kitty_protocol(s);
+    ansi::query_synchronized_output(s);
     std::print("{}", s);
     std::fflush(stdout);
 
@@ -1,5 +1,8 @@
 #include "regex.hpp"
 
+#include <format>
+#include <stdexcept>
+
 #include "util/utf8.hpp"
 
 Regex::Regex(const std::string_view pattern) {
@@ -25,10 +28,42 @@ Regex::Regex(const std::string_view pattern) {
     this->match_data_ = std::shared_ptr<pcre2_match_data>(match_data, pcre2_match_data_free);
 }
 
-[[nodiscard]]
 auto Regex::search(const std::string_view text) const -> std::vector<RegexMatch> {
     std::vector<RegexMatch> matches;
+    this->for_each_match(
+        text, [&](const PCRE2_SIZE* ovector) -> void { matches.emplace_back(ovector[0], ovector[1]); });
+
+    return matches;
+}
+
+auto Regex::replace(const std::string_view text, const std::string_view tmpl) const -> std::vector<Edit> {
+    const auto segments = this->parse_template(tmpl);
+
+    std::vector<Edit> edits{};
+    this->for_each_match(text, [&](const PCRE2_SIZE* ovector) -> void {
+        std::string replacement{};
+        for (const auto& segment: segments) {
+            if (!segment.group_) {
+                replacement += segment.text_;
+                continue;
+            }
+
+            // Groups that did not participate in the match expand to nothing.
+            const auto group_start = ovector[2 * *segment.group_];
+            const auto group_end = ovector[(2 * *segment.group_) + 1];
+            if (group_start != PCRE2_UNSET && group_end != PCRE2_UNSET) {
+                replacement += text.substr(group_start, group_end - group_start);
+            }
+        }
+
+        edits.push_back(Edit{.start_ = ovector[0], .end_ = ovector[1], .text_ = std::move(replacement)});
+    });
+
+    return edits;
+}
 
+void Regex::for_each_match(
+    const std::string_view text, const std::function<void(const PCRE2_SIZE* ovector)>& fn) const {
     const auto* const data = reinterpret_cast<PCRE2_SPTR>(text.data());
     const PCRE2_SIZE len = text.size();
     PCRE2_SIZE offset{0};
@@ -55,9 +90,70 @@ auto Regex::search(const std::string_view text) const -> std::vector<RegexMatch>
             continue;
         }
 
-        matches.emplace_back(start, end);
+        fn(ovector);
         offset = end;
     }
+}
 
-    return matches;
+auto Regex::parse_template(const std::string_view tmpl) const -> std::vector<Segment> {
+    std::uint32_t capture_count{0};
+    pcre2_pattern_info(this->code_.get(), PCRE2_INFO_CAPTURECOUNT, &capture_count);
+
+    std::vector<Segment> segments{};
+    const auto push_text = [&](const std::string_view text) -> void {
+        if (text.empty()) { return; }
+        if (segments.empty() || segments.back().group_) { segments.emplace_back(); }
+        segments.back().text_ += text;
+    };
+    const auto push_group = [&](const std::string_view ref) -> void {
+        auto group{0UZ};
+        if (ref.find_first_not_of("0123456789") == std::string_view::npos) {
+            for (const auto ch: ref) { group = (group * 10) + static_cast<std::size_t>(ch - '0'); }
+        } else {
+            const auto name = std::string(ref);
+            const auto number =
+                pcre2_substring_number_from_name(this->code_.get(), reinterpret_cast<PCRE2_SPTR>(name.c_str()));
+            if (number < 0) { throw std::runtime_error(std::format("unknown capture group \"{}\"", ref)); }
+            group = static_cast<std::size_t>(number);
+        }
+
+        if (group > capture_count) { throw std::runtime_error(std::format("unknown capture group \"{}\"", ref)); }
+        segments.push_back(Segment{.text_ = {}, .group_ = group});
+    };
+
+    auto idx{0UZ};
+    while (idx < tmpl.size()) {
+        const auto dollar = tmpl.find('$', idx);
+        push_text(tmpl.substr(idx, dollar - idx));
+        if (dollar == std::string_view::npos || dollar + 1 == tmpl.size()) {
+            if (dollar != std::string_view::npos) { push_text("$"); }
+            break;
+        }
+
+        const auto next = tmpl[dollar + 1];
+        if (next == '$') {
+            push_text("$");
+            idx = dollar + 2;
+        } else if (next == '{') {
+            const auto close = tmpl.find('}', dollar + 2);
+            if (close == std::string_view::npos || close == dollar + 2) {
+                throw std::runtime_error("invalid capture group reference");
+            }
+
+            push_group(tmpl.substr(dollar + 2, close - (dollar + 2)));
+            idx = close + 1;
+        } else if (next >= '0' && next <= '9') {
+            auto end = tmpl.find_first_not_of("0123456789", dollar + 1);
+            if (end == std::string_view::npos) { end = tmpl.size(); }
+
+            push_group(tmpl.substr(dollar + 1, end - (dollar + 1)));
+            idx = end;
+        } else {
+            // A lone $ is taken literally.
+            push_text("$");
+            idx = dollar + 1;
+        }
+    }
+
+    return segments;
 }
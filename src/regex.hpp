@@ -3,15 +3,27 @@
 
 #define PCRE2_CODE_UNIT_WIDTH 8
 
+#include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include <pcre2.h>
 
+#include "types/edit.hpp"
 #include "types/regex_match.hpp"
 
 struct Regex {
+private:
+    /// A part of a replacement template, either literal text or a reference to a capture group.
+    struct Segment {
+    public:
+        std::string text_;
+        std::optional<std::size_t> group_;
+    };
+
 private:
     std::shared_ptr<pcre2_code> code_{nullptr};
     std::shared_ptr<pcre2_match_data> match_data_{nullptr};
@@ -22,6 +34,17 @@ public:
     /// Searches a text and returns all matches.
     [[nodiscard]]
     auto search(std::string_view text) const -> std::vector<RegexMatch>;
+    /// Searches a text and returns an Edit replacing every match with the expanded template. $n and ${n} expand to the
+    /// nth capture group, ${name} to the named capture group and $$ to a literal $. Throws on invalid references.
+    [[nodiscard]]
+    auto replace(std::string_view text, std::string_view tmpl) const -> std::vector<Edit>;
+
+private:
+    /// Calls fn with the output vector of every non-empty match in text.
+    void for_each_match(std::string_view text, const std::function<void(const PCRE2_SIZE* ovector)>& fn) const;
+    /// Splits a replacement template into literal text and capture group references.
+    [[nodiscard]]
+    auto parse_template(std::string_view tmpl) const -> std::vector<Segment>;
 };
 
 #endif
@@ -2,74 +2,99 @@
 
 #include <algorithm>
 #include <cstring>
+#include <type_traits>
 
 #include "../types/face.hpp"
 
+// Comparing object representations is only valid without padding.
+static_assert(sizeof(Cell) == 16);
+static_assert(std::has_unique_object_representations_v<Cell>);
+static_assert(std::is_trivially_copyable_v<Cell>);
+
 Cell::Cell(
     const unsigned char ch, const Rgb fg, const Rgb bg, const bool bold, const bool italic, const bool underline,
     const bool strikethrough)
-    : fg_{fg}, bg_{bg}, bold_{bold}, italic_{italic}, underline_{underline}, strikethrough_{strikethrough} {
+    : fg_{Cell::pack(fg)}, bg_{Cell::pack(bg)} {
     this->set_char(ch);
+    this->set_flag(Cell::BOLD, bold);
+    this->set_flag(Cell::ITALIC, italic);
+    this->set_flag(Cell::UNDERLINE, underline);
+    this->set_flag(Cell::STRIKETHROUGH, strikethrough);
 }
 
 Cell::Cell(const unsigned char ch, const Face face) {
     this->set_char(ch);
-    if (face.fg_) { this->fg_ = *face.fg_; }
-    if (face.bg_) { this->bg_ = *face.bg_; }
-
-    if (face.bold_) { this->bold_ = *face.bold_; }
-    if (face.italic_) { this->italic_ = *face.italic_; }
-    if (face.underline_) { this->underline_ = *face.underline_; }
-    if (face.strikethrough_) { this->strikethrough_ = *face.strikethrough_; }
+    this->set_face(face);
 }
 
 Cell::Cell(
     const std::string_view str, const Rgb fg, const Rgb bg, const bool bold, const bool italic, const bool underline,
     const bool strikethrough)
-    : fg_{fg}, bg_{bg}, bold_{bold}, italic_{italic}, underline_{underline}, strikethrough_{strikethrough} {
+    : fg_{Cell::pack(fg)}, bg_{Cell::pack(bg)} {
     this->set_utf8(str);
+    this->set_flag(Cell::BOLD, bold);
+    this->set_flag(Cell::ITALIC, italic);
+    this->set_flag(Cell::UNDERLINE, underline);
+    this->set_flag(Cell::STRIKETHROUGH, strikethrough);
 }
 
 Cell::Cell(const std::string_view str, const Face face) {
     this->set_utf8(str);
-    if (face.fg_) { this->fg_ = *face.fg_; }
-    if (face.bg_) { this->bg_ = *face.bg_; }
-
-    if (face.bold_) { this->bold_ = *face.bold_; }
-    if (face.italic_) { this->italic_ = *face.italic_; }
-    if (face.underline_) { this->underline_ = *face.underline_; }
-    if (face.strikethrough_) { this->strikethrough_ = *face.strikethrough_; }
+    this->set_face(face);
 }
 
 void Cell::set_char(const unsigned char ch) {
-    this->data_[0] = ch;
-    this->data_[1] = 0;
-    this->len_ = 1;
+    this->data_ = {ch, 0, 0, 0};
+    this->attrs_ = (this->attrs_ & ~Cell::LEN_MASK) | 1;
 }
 
 void Cell::set_utf8(const std::string_view str) {
-    const auto n = std::min(str.size(), 4UZ);
+    const auto n = std::min(str.size(), this->data_.size());
+    this->data_ = {};
     std::memcpy(this->data_.data(), str.data(), n);
-    data_[n] = 0;
-    len_ = static_cast<uint8_t>(n);
+    this->attrs_ = (this->attrs_ & ~Cell::LEN_MASK) | static_cast<std::uint32_t>(n);
 }
 
 void Cell::set_face(const Face face) {
-    if (face.fg_) { this->fg_ = *face.fg_; }
-    if (face.bg_) { this->bg_ = *face.bg_; }
+    if (face.fg_) { this->fg_ = Cell::pack(*face.fg_); }
+    if (face.bg_) { this->bg_ = Cell::pack(*face.bg_); }
 
-    if (face.bold_) { this->bold_ = *face.bold_; }
-    if (face.italic_) { this->italic_ = *face.italic_; }
-    if (face.underline_) { this->underline_ = *face.underline_; }
-    if (face.strikethrough_) { this->strikethrough_ = *face.strikethrough_; }
+    if (face.bold_) { this->set_flag(Cell::BOLD, *face.bold_); }
+    if (face.italic_) { this->set_flag(Cell::ITALIC, *face.italic_); }
+    if (face.underline_) { this->set_flag(Cell::UNDERLINE, *face.underline_); }
+    if (face.strikethrough_) { this->set_flag(Cell::STRIKETHROUGH, *face.strikethrough_); }
 }
 
+auto Cell::data() const -> std::string_view {
+    return {reinterpret_cast<const char*>(this->data_.data()), this->len()};
+}
+auto Cell::len() const -> std::size_t { return this->attrs_ & Cell::LEN_MASK; }
+
+auto Cell::fg() const -> Rgb { return Cell::unpack(this->fg_); }
+auto Cell::bg() const -> Rgb { return Cell::unpack(this->bg_); }
+auto Cell::bold() const -> bool { return (this->attrs_ & Cell::BOLD) != 0; }
+auto Cell::italic() const -> bool { return (this->attrs_ & Cell::ITALIC) != 0; }
+auto Cell::underline() const -> bool { return (this->attrs_ & Cell::UNDERLINE) != 0; }
+auto Cell::strikethrough() const -> bool { return (this->attrs_ & Cell::STRIKETHROUGH) != 0; }
+
 auto Cell::operator==(const Cell& rhs) const -> bool {
-    const auto equal_data = std::ranges::equal(
-        this->data_.data(), this->data_.data() + this->len_, rhs.data_.data(), rhs.data_.data() + rhs.len_);
-    return equal_data && this->fg_ == rhs.fg_ && this->bg_ == rhs.bg_ && this->bold_ == rhs.bold_
-        && this->italic_ == rhs.italic_ && this->underline_ == rhs.underline_
-        && this->strikethrough_ == rhs.strikethrough_;
+    // Compiles to a single wide comparison, unused bytes are kept zero.
+    return std::memcmp(this, &rhs, sizeof(Cell)) == 0;
 }
 
 auto Cell::operator!=(const Cell& rhs) const -> bool { return !(*this == rhs); }
+
+void Cell::set_flag(const std::uint32_t flag, const bool value) {
+    this->attrs_ = value ? this->attrs_ | flag : this->attrs_ & ~flag;
+}
+
+auto Cell::pack(const Rgb rgb) -> std::uint32_t {
+    return (static_cast<std::uint32_t>(rgb.r_) << 16) | (static_cast<std::uint32_t>(rgb.g_) << 8) | rgb.b_;
+}
+
+auto Cell::unpack(const std::uint32_t rgb) -> Rgb {
+    return Rgb{
+        .r_ = static_cast<std::uint8_t>(rgb >> 16),
+        .g_ = static_cast<std::uint8_t>(rgb >> 8),
+        .b_ = static_cast<std::uint8_t>(rgb)};
+}
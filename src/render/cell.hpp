@@ -2,6 +2,7 @@
 #define CELL_HPP_
 
 #include <array>
+#include <cstdint>
 #include <string_view>
 
 #include "../types/rgb.hpp"
@@ -10,24 +11,29 @@ struct Face;
 
 /// A Cell represents one cell in the Display. It stores a four-byte UTF-8 character and corresponding cell color.
 ///
+/// Cells are packed into 16 bytes so a Display row is a contiguous run of trivially comparable Cells: the character
+/// bytes inline, both colors as 0xRRGGBB words and an attribute word holding the byte length and style flags. Unused
+/// bytes are always zero, which makes comparing two Cells a single comparison of their object representations.
+///
 /// Cell data must be managed through the API of this class and never directly inserted. Failure to do so can result in
 /// UB and crashes.
 struct Cell {
-public:
-    /// Unicode codepoint data of a character.
-    std::array<unsigned char, 5> data_{};
-    /// Byte length of the codepoint.
-    std::uint8_t len_{0};
+private:
+    /// Bits of the attribute word holding the byte length of the character.
+    static constexpr std::uint32_t LEN_MASK{0x7};
+    static constexpr std::uint32_t BOLD{1U << 3};
+    static constexpr std::uint32_t ITALIC{1U << 4};
+    static constexpr std::uint32_t UNDERLINE{1U << 5};
+    static constexpr std::uint32_t STRIKETHROUGH{1U << 6};
 
+    /// UTF-8 bytes of the character, zero padded.
+    std::array<unsigned char, 4> data_{};
     /// Foreground color.
-    Rgb fg_{.r_ = 255, .g_ = 255, .b_ = 255};
+    std::uint32_t fg_{0xFFFFFF};
     /// Background color.
-    Rgb bg_{.r_ = 0, .g_ = 0, .b_ = 0};
-
-    bool bold_{false};
-    bool italic_{false};
-    bool underline_{false};
-    bool strikethrough_{false};
+    std::uint32_t bg_{0x000000};
+    /// Byte length of the character and style flags.
+    std::uint32_t attrs_{0};
 
 public:
     Cell() = default;
@@ -47,10 +53,36 @@ public:
     /// Sets the Cell's Face.
     void set_face(Face face);
 
+    /// Gets the UTF-8 bytes of the character. Cells with an empty character are not drawn.
+    [[nodiscard]]
+    auto data() const -> std::string_view;
+    [[nodiscard]]
+    auto len() const -> std::size_t;
+
+    [[nodiscard]]
+    auto fg() const -> Rgb;
+    [[nodiscard]]
+    auto bg() const -> Rgb;
+    [[nodiscard]]
+    auto bold() const -> bool;
+    [[nodiscard]]
+    auto italic() const -> bool;
+    [[nodiscard]]
+    auto underline() const -> bool;
+    [[nodiscard]]
+    auto strikethrough() const -> bool;
+
     [[nodiscard]]
     auto operator==(const Cell& rhs) const -> bool;
     [[nodiscard]]
     auto operator!=(const Cell& rhs) const -> bool;
+
+private:
+    void set_flag(std::uint32_t flag, bool value);
+    [[nodiscard]]
+    static auto pack(Rgb rgb) -> std::uint32_t;
+    [[nodiscard]]
+    static auto unpack(std::uint32_t rgb) -> Rgb;
 };
 
 #endif
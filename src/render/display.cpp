@@ -1,21 +1,35 @@
 #include "display.hpp"
 
+#include <algorithm>
+
 #include "../util/assert.hpp"
 
+namespace {
+    /// Gets the count of decimal digits of a number.
+    auto digits(std::size_t num) -> std::size_t {
+        auto res{1UZ};
+        for (; num >= 10; num /= 10) { res += 1; }
+
+        return res;
+    }
+} // namespace
+
 Display::Display() {
     // Store instance in the write request to have access to this in callback.
     this->write_req_.data = this;
     this->output_buffer_.reserve(4096);
 }
 
+auto Display::width() const -> std::size_t { return this->width_; }
+
 void Display::resize(const std::size_t width, const std::size_t height) {
     if (this->width_ == width && this->height_ == height) { return; }
 
     this->width_ = width;
     this->height_ = height;
 
-    this->grid_.resize(height);
-    for (auto& row: this->grid_) { row.resize(width, Cell(" ")); }
+    // The old content is not preserved since a full redraw overwrites every cell anyway.
+    this->grid_.assign(width * height, Cell(" "));
 
     this->full_redraw_ = true;
 }
@@ -24,15 +38,60 @@ void Display::update(std::size_t x, std::size_t y, const Cell& cell) {
     ASSERT_DEBUG // NOLINT(readability-simplify-boolean-expr)
         (x < this->width_ && y < this->height_, "Coordinates must be inside screen space.");
 
+    const auto idx = y * this->width_ + x;
+
     // Always overwrite on full redraw since the old state is invalidated.
-    if (this->full_redraw_ || this->grid_[y][x] != cell) {
-        this->grid_[y][x] = cell;
+    if (this->full_redraw_ || this->grid_[idx] != cell) {
+        this->grid_[idx] = cell;
 
         // Only push dirty if not a full redraw since all cells get drawn on full redraw anyway.
-        if (!this->full_redraw_) { this->dirty_.emplace_back(x, y); }
+        if (!this->full_redraw_) { this->dirty_.push_back(idx); }
     }
 }
 
+void Display::scroll(const std::size_t top, const std::size_t bottom, const std::ptrdiff_t n) {
+    ASSERT_DEBUG // NOLINT(readability-simplify-boolean-expr)
+        (top <= bottom && bottom <= this->height_, "Scroll region must be inside screen space.");
+
+    const auto dist = static_cast<std::size_t>(n < 0 ? -n : n);
+    // Everything gets drawn anyway or no content would be kept.
+    if (n == 0 || this->full_redraw_ || dist >= bottom - top) { return; }
+
+    const auto begin = this->grid_.begin() + static_cast<std::ptrdiff_t>(top * this->width_);
+    const auto end = this->grid_.begin() + static_cast<std::ptrdiff_t>(bottom * this->width_);
+    const auto shift = static_cast<std::ptrdiff_t>(dist * this->width_);
+
+    // The exposed rows are blank on the terminal after scrolling and must be written whatever they get updated to.
+    const auto exposed = n > 0 ? bottom - dist : top;
+    if (n > 0) {
+        std::shift_left(begin, end, shift);
+    } else {
+        std::shift_right(begin, end, shift);
+    }
+
+    // Pending dirty cells move along with the content, cells scrolled out of the region are dropped.
+    const auto region_begin = top * this->width_;
+    const auto region_end = bottom * this->width_;
+    std::erase_if(this->dirty_, [&](auto& idx) -> bool {
+        if (idx < region_begin || idx >= region_end) { return false; }
+
+        const auto moved = static_cast<std::ptrdiff_t>(idx) - n * static_cast<std::ptrdiff_t>(this->width_);
+        if (moved < static_cast<std::ptrdiff_t>(region_begin) || moved >= static_cast<std::ptrdiff_t>(region_end)) {
+            return true;
+        }
+
+        idx = static_cast<std::size_t>(moved);
+        return false;
+    });
+
+    for (auto idx = exposed * this->width_; idx < (exposed + dist) * this->width_; idx += 1) {
+        this->grid_[idx] = Cell{};
+        this->dirty_.push_back(idx);
+    }
+
+    this->scrolls_.push_back(Scroll{.top_ = top, .bottom_ = bottom, .n_ = n});
+}
+
 void Display::cursor(const std::size_t row, const std::size_t col, const ansi::CursorStyle style) {
     ASSERT_DEBUG // NOLINT(readability-simplify-boolean-expr)
         (col < this->width_ && row < this->height_, "Cursor must be inside screen space.");
@@ -43,41 +102,61 @@ void Display::cursor(const std::size_t row, const std::size_t col, const ansi::C
 }
 
 void Display::render(uv_tty_t* tty) {
-    // The previous render pass has not been finished by libuv yet, abort.
-    if (this->is_writing_) { return; }
+    ASSERT(!this->is_writing_, "The previous frame must be written before rendering the next one.");
 
     this->back_buffer_.clear();
 
+    this->pen_pos_ = std::nullopt;
+    this->pen_ = Face{};
+    this->naive_prev_ = std::nullopt;
+    this->frame_ = FrameStats{};
+
     // Avoid flickering during writing.
+    if (this->synchronized_) { ansi::begin_synchronized_update(this->back_buffer_); }
     ansi::hide_cursor(this->back_buffer_);
 
+    auto run_bytes{0UZ};
     if (this->full_redraw_) {
         ansi::clear(this->back_buffer_);
+        this->scrolls_.clear();
 
-        std::optional<Rgb> last_fg{};
-        std::optional<Rgb> last_bg{};
-        std::optional<bool> last_bold{};
-        std::optional<bool> last_italic{};
-        std::optional<bool> last_underline{};
-        std::optional<bool> last_strike{};
-        for (auto y{0UZ}; y < this->height_; y += 1) {
-            for (auto x{0UZ}; x < this->width_; x += 1) {
-                this->render_cell(
-                    x, y, this->grid_[y][x], last_fg, last_bg, last_bold, last_italic, last_underline, last_strike);
-            }
+        for (auto row{0UZ}; row < this->height_; row += 1) {
+            const auto size = this->back_buffer_.size();
+            this->render_run(row * this->width_, (row + 1) * this->width_);
+            run_bytes += this->back_buffer_.size() - size;
         }
 
         this->full_redraw_ = false;
     } else if (!this->dirty_.empty()) {
-        std::optional<Rgb> last_fg{};
-        std::optional<Rgb> last_bg{};
-        std::optional<bool> last_bold{};
-        std::optional<bool> last_italic{};
-        std::optional<bool> last_underline{};
-        std::optional<bool> last_strike{};
-        for (const auto& [x, y]: this->dirty_) {
-            this->render_cell(
-                x, y, this->grid_[y][x], last_fg, last_bg, last_bold, last_italic, last_underline, last_strike);
+        // Scrolls are replayed before writing any cells since dirty cells are positioned after them.
+        for (const auto& scroll: this->scrolls_) {
+            ansi::scroll_region(this->back_buffer_, scroll.top_ + 1, scroll.bottom_);
+            if (scroll.n_ > 0) {
+                ansi::scroll_up(this->back_buffer_, static_cast<std::size_t>(scroll.n_));
+            } else {
+                ansi::scroll_down(this->back_buffer_, static_cast<std::size_t>(-scroll.n_));
+            }
+        }
+        if (!this->scrolls_.empty()) { ansi::reset_scroll_region(this->back_buffer_); }
+        this->scrolls_.clear();
+
+        // Cells are written in screen order, consecutive dirty cells of a row form a run.
+        std::ranges::sort(this->dirty_);
+        const auto [first, last] = std::ranges::unique(this->dirty_);
+        this->dirty_.erase(first, last);
+
+        auto begin{0UZ};
+        for (auto idx{1UZ}; idx <= this->dirty_.size(); idx += 1) {
+            if (idx < this->dirty_.size() && this->dirty_[idx] == this->dirty_[idx - 1] + 1
+                && this->dirty_[idx] % this->width_ != 0) {
+                continue;
+            }
+
+            const auto size = this->back_buffer_.size();
+            this->render_run(this->dirty_[begin], this->dirty_[idx - 1] + 1);
+            run_bytes += this->back_buffer_.size() - size;
+
+            begin = idx;
         }
     }
     this->dirty_.clear();
@@ -88,49 +167,139 @@ void Display::render(uv_tty_t* tty) {
     ansi::move_to(this->back_buffer_, this->cur_.row_, this->cur_.col_);
     ansi::cursor(this->back_buffer_, this->cur_style_);
     if (this->cur_style_ != ansi::CursorStyle::HIDDEN) { ansi::show_cursor(this->back_buffer_); }
+    if (this->synchronized_) { ansi::end_synchronized_update(this->back_buffer_); }
+
+    // Sequences around the cells are the same for both encodings.
+    this->frame_.bytes_ = this->back_buffer_.size();
+    this->frame_.naive_bytes_ += this->back_buffer_.size() - run_bytes;
 
     this->flush(tty);
 }
 
-void Display::render_cell(
-    const std::size_t x, const std::size_t y, const Cell& cell, std::optional<Rgb>& last_fg,
-    std::optional<Rgb>& last_bg, std::optional<bool>& last_bold, std::optional<bool>& last_italic,
-    std::optional<bool>& last_underline, std::optional<bool>& last_strikethrough) {
-    // Cells with length 0 won't be rendered, since nothing would be seen.
-    if (cell.len_ == 0) { return; }
+auto Display::writing() const -> bool { return this->is_writing_; }
 
-    ansi::move_to(this->back_buffer_, y + 1, x + 1);
+void Display::synchronize(const bool enabled) { this->synchronized_ = enabled; }
 
-    // Only write and update color if it changed.
-    if (!last_fg.has_value() || *last_fg != cell.fg_) {
-        ansi::rgb(this->back_buffer_, cell.fg_);
-        last_fg = cell.fg_;
-    }
-    if (!last_bg.has_value() || *last_bg != cell.bg_) {
-        ansi::rgb(this->back_buffer_, cell.bg_, false);
-        last_bg = cell.bg_;
-    }
+auto Display::last_frame() const -> const FrameStats& { return this->frame_; }
 
-    // Only write and update style if it changed.
-    if (!last_bold.has_value() || *last_bold != cell.bold_) {
-        ansi::bold(this->back_buffer_, cell.bold_);
-        last_bold = cell.bold_;
-    }
-    if (!last_italic.has_value() || *last_italic != cell.italic_) {
-        ansi::italic(this->back_buffer_, cell.italic_);
-        last_italic = cell.italic_;
+void Display::render_run(const std::size_t begin, const std::size_t end) {
+    const auto row_end = (begin / this->width_ + 1) * this->width_;
+    ASSERT_DEBUG // NOLINT(readability-simplify-boolean-expr)
+        (begin <= end && end <= row_end, "Runs must not span multiple rows.");
+
+    auto idx = begin;
+    while (idx < end) {
+        const auto& cell = this->grid_[idx];
+
+        // Cells with length 0 won't be rendered, since nothing would be seen.
+        if (cell.len() == 0) {
+            idx += 1;
+            continue;
+        }
+
+        // Blank cells are spaces without visible decorations, only their background is seen.
+        if (cell.data() == " " && !cell.underline() && !cell.strikethrough()) {
+            auto jdx = idx;
+            while (jdx < end && this->grid_[jdx] == cell) {
+                this->count_naive(jdx);
+                jdx += 1;
+            }
+            const auto n = jdx - idx;
+
+            // Erasing requires moving past the erased cells afterwards, unless the line is erased to its end.
+            const auto erase_line = jdx == row_end && n > 3;
+            const auto erase_chars = n > 2 * (digits(n) + 3);
+            if (erase_line || erase_chars) {
+                this->move_cursor(idx);
+                this->apply_style(cell, true);
+                if (erase_line) {
+                    ansi::erase_line(this->back_buffer_);
+                } else {
+                    ansi::erase_chars(this->back_buffer_, n);
+                }
+
+                idx = jdx;
+                continue;
+            }
+
+            // Writing the spaces is shorter.
+            for (; idx < jdx; idx += 1) {
+                this->move_cursor(idx);
+                this->apply_style(cell, true);
+                this->back_buffer_.push_back(' ');
+                this->pen_pos_ = (idx + 1) % this->width_ != 0 ? std::make_optional(idx + 1) : std::nullopt;
+            }
+            continue;
+        }
+
+        this->count_naive(idx);
+        this->move_cursor(idx);
+        this->apply_style(cell, false);
+        this->back_buffer_.append(cell.data());
+
+        // The cursor waits at the last column for the next character to wrap. Terminals disagree on the width of many
+        // non-ASCII characters, so the cursor is only tracked past ASCII characters.
+        const auto ascii = cell.len() == 1 && static_cast<unsigned char>(cell.data()[0]) < 0x80;
+        this->pen_pos_ = ascii && (idx + 1) % this->width_ != 0 ? std::make_optional(idx + 1) : std::nullopt;
+
+        idx += 1;
     }
-    if (!last_underline.has_value() || *last_underline != cell.underline_) {
-        ansi::underline(this->back_buffer_, cell.underline_);
-        last_underline = cell.underline_;
+}
+
+void Display::move_cursor(const std::size_t idx) {
+    if (this->pen_pos_ == idx) { return; }
+
+    // Moving forward is shorter than moving to an absolute position.
+    if (this->pen_pos_ && *this->pen_pos_ < idx && *this->pen_pos_ / this->width_ == idx / this->width_) {
+        ansi::move_forward(this->back_buffer_, idx - *this->pen_pos_);
+    } else {
+        ansi::move_to(
+            this->back_buffer_, static_cast<std::uint16_t>(idx / this->width_ + 1),
+            static_cast<std::uint16_t>(idx % this->width_ + 1));
     }
-    if (!last_strikethrough.has_value() || *last_strikethrough != cell.strikethrough_) {
-        ansi::strikethrough(this->back_buffer_, cell.strikethrough_);
-        last_strikethrough = cell.strikethrough_;
+
+    this->pen_pos_ = idx;
+}
+
+void Display::apply_style(const Cell& cell, const bool blank) {
+    Face changed{};
+
+    // Only write attributes that changed. Decorations would be drawn on blank cells too.
+    if (this->pen_.bg_ != cell.bg()) { changed.bg_ = cell.bg(); }
+    if (this->pen_.underline_ != cell.underline()) { changed.underline_ = cell.underline(); }
+    if (this->pen_.strikethrough_ != cell.strikethrough()) { changed.strikethrough_ = cell.strikethrough(); }
+    if (!blank) {
+        if (this->pen_.fg_ != cell.fg()) { changed.fg_ = cell.fg(); }
+        if (this->pen_.bold_ != cell.bold()) { changed.bold_ = cell.bold(); }
+        if (this->pen_.italic_ != cell.italic()) { changed.italic_ = cell.italic(); }
     }
 
-    // Add the cell's Unicode codepoint.
-    this->back_buffer_.append(cell.data_.data(), cell.data_.data() + cell.len_);
+    ansi::style(
+        this->back_buffer_, changed.fg_, changed.bg_, changed.bold_, changed.italic_, changed.underline_,
+        changed.strikethrough_);
+    this->pen_.merge(changed);
+}
+
+void Display::count_naive(const std::size_t idx) {
+    const auto& cell = this->grid_[idx];
+    const auto rgb = [&](const Rgb color) -> std::size_t {
+        return 10 + digits(color.r_) + digits(color.g_) + digits(color.b_);
+    };
+
+    // Cursor movement and the character.
+    auto bytes = 4 + digits(idx / this->width_ + 1) + digits(idx % this->width_ + 1) + cell.len();
+
+    // Every changed attribute is its own sequence.
+    const auto& prev = this->naive_prev_;
+    if (!prev || prev->fg() != cell.fg()) { bytes += rgb(cell.fg()); }
+    if (!prev || prev->bg() != cell.bg()) { bytes += rgb(cell.bg()); }
+    if (!prev || prev->bold() != cell.bold()) { bytes += cell.bold() ? 4 : 5; }
+    if (!prev || prev->italic() != cell.italic()) { bytes += cell.italic() ? 4 : 5; }
+    if (!prev || prev->underline() != cell.underline()) { bytes += cell.underline() ? 4 : 5; }
+    if (!prev || prev->strikethrough() != cell.strikethrough()) { bytes += cell.strikethrough() ? 4 : 5; }
+
+    this->frame_.naive_bytes_ += bytes;
+    this->naive_prev_ = cell;
 }
 
 void Display::flush(uv_tty_t* tty) {
@@ -149,7 +318,7 @@ void Display::flush(uv_tty_t* tty) {
         auto* self = static_cast<Display*>(req->data);
         self->is_writing_ = false;
 
-        // Call callback when redraw was requested while drawing.
-        if ((self->full_redraw_ || !self->dirty_.empty()) && self->ready_) { self->ready_(); }
+        // Frames requested while writing were held back.
+        if (self->ready_) { self->ready_(); }
     });
 }
@@ -1,22 +1,50 @@
 #ifndef DISPLAY_HPP_
 #define DISPLAY_HPP_
 
+#include <cstddef>
 #include <functional>
 #include <optional>
 #include <vector>
 
 #include <uv.h>
 
+#include "../types/face.hpp"
 #include "../types/position.hpp"
 #include "../util/ansi.hpp"
 #include "cell.hpp"
 
+/// Output statistics of a rendered frame.
+struct FrameStats {
+public:
+    /// Bytes written to the terminal.
+    std::size_t bytes_{0};
+    /// Bytes the frame would have taken if every cell was moved to and styled on its own.
+    std::size_t naive_bytes_{0};
+};
+
 /// The Display abstracts the terminal and handles managing the grid and writing the cells efficiently using double
 /// buffering and diffed-rendering.
+///
+/// Vertical scrolls of full-width regions are applied to the grid and replayed on the terminal through scroll regions,
+/// so only the exposed rows need to be written.
+///
+/// Dirty cells are written in screen order as horizontal runs. The encoder tracks the terminal cursor and attributes,
+/// so contiguous cells are written without moving the cursor, changed attributes are combined into a single sequence
+/// and long runs of blank cells are erased instead of overwritten.
 struct Display {
 public:
+    /// Called once a frame has been written to the terminal.
     std::function<void()> ready_{nullptr};
 
+private:
+    /// A scroll of the rows from top to bottom (zero indexed, end exclusive). Positive distances scroll the content up.
+    struct Scroll {
+    public:
+        std::size_t top_;
+        std::size_t bottom_;
+        std::ptrdiff_t n_;
+    };
+
 private:
     /// Write request to handle libuv stdout.
     uv_write_t write_req_{};
@@ -24,6 +52,8 @@ private:
     bool is_writing_{false};
     /// Full redraw flag for specific logic.
     bool full_redraw_{true};
+    /// Wrap frames in synchronized updates.
+    bool synchronized_{false};
 
     std::size_t width_{0};
     std::size_t height_{0};
@@ -31,16 +61,26 @@ private:
     /// Terminal hardware cursor position (one indexed).
     Position cur_{};
     ansi::CursorStyle cur_style_{ansi::CursorStyle::STEADY_BLOCK};
-    /// Cell grid of the terminal.
-    std::vector<std::vector<Cell>> grid_{};
-    /// Dirty cells that need to be written to the terminal.
-    std::vector<std::pair<int, int>> dirty_{};
+    /// Cell grid of the terminal, stored contiguously row by row.
+    std::vector<Cell> grid_{};
+    /// Grid indices of dirty cells that need to be written to the terminal.
+    std::vector<std::size_t> dirty_{};
+    /// Scrolls applied to the grid but not yet to the terminal, in order.
+    std::vector<Scroll> scrolls_{};
 
     /// Double buffer back buffer.
     std::string back_buffer_{};
     /// Double buffer output buffer.
     std::string output_buffer_{};
 
+    /// Grid index of the terminal cursor while encoding a frame, if known.
+    std::optional<std::size_t> pen_pos_{};
+    /// Attributes known to be set on the terminal while encoding a frame.
+    Face pen_{};
+    /// Last cell drawn by the per-cell encoding the frame statistics compare against.
+    std::optional<Cell> naive_prev_{};
+    FrameStats frame_{};
+
 public:
     Display();
 
@@ -49,21 +89,41 @@ public:
     Display(Display&&) noexcept = default;
     auto operator=(Display&&) noexcept -> Display& = default;
 
+    /// Gets the width of the Display.
+    [[nodiscard]]
+    auto width() const -> std::size_t;
+
     /// Resizes the Display.
     void resize(std::size_t width, std::size_t height);
     /// Updates a Cell.
     void update(std::size_t x, std::size_t y, const Cell& cell);
+    /// Scrolls the content of the rows from top to bottom (zero indexed, end exclusive) up by n rows, or down if n is
+    /// negative. The scroll spans the full width of the Display. Exposed rows must be updated before the next render.
+    void scroll(std::size_t top, std::size_t bottom, std::ptrdiff_t n);
     /// Sets the Cursor (zero indexed).
     void cursor(std::size_t row, std::size_t col, ansi::CursorStyle style = ansi::CursorStyle::STEADY_BLOCK);
-    /// Renders the Display to stdout.
+    /// Renders the Display to stdout. Must not be called while the last frame is still being written.
     void render(uv_tty_t* tty);
+    /// Checks if the last frame is still being written.
+    [[nodiscard]]
+    auto writing() const -> bool;
+    /// Enables wrapping frames in synchronized updates, which must only be done if the terminal supports them.
+    void synchronize(bool enabled);
+
+    /// Gets the statistics of the last rendered frame.
+    [[nodiscard]]
+    auto last_frame() const -> const FrameStats&;
 
 private:
-    /// Writes the ANSI sequences to render a Cell to the buffer (zero indexed).
-    void render_cell(
-        std::size_t x, std::size_t y, const Cell& cell, std::optional<Rgb>& last_fg, std::optional<Rgb>& last_bg,
-        std::optional<bool>& last_bold, std::optional<bool>& last_italic, std::optional<bool>& last_underline,
-        std::optional<bool>& last_strikethrough);
+    /// Writes the ANSI sequences to render the cells from begin to end of a single row to the buffer.
+    void render_run(std::size_t begin, std::size_t end);
+    /// Moves the terminal cursor to a grid index unless it already is there.
+    void move_cursor(std::size_t idx);
+    /// Sets the attributes of a Cell that differ from the ones set on the terminal. Blank cells do not need their
+    /// foreground, boldness or slant.
+    void apply_style(const Cell& cell, bool blank);
+    /// Adds the bytes the per-cell encoding takes for a Cell to the frame statistics.
+    void count_naive(std::size_t idx);
     /// Flushes the buffer to stdout via libuv.
     void flush(uv_tty_t* tty);
 };
@@ -48,12 +48,12 @@ void Window::resize(const std::size_t x, const std::size_t y, const std::size_t
     }
 }
 
-auto Window::render(Display& display, const sol::protected_function& resolve_face) const -> bool {
+auto Window::render(Display& display, FaceRegistry& faces) const -> bool {
     if (this->viewport_) {
-        if (!this->viewport_->render(display, resolve_face)) { return false; }
+        if (!this->viewport_->render(display, faces)) { return false; }
     } else {
-        if (!this->child_1_->render(display, resolve_face)) { return false; }
-        if (!this->child_2_->render(display, resolve_face)) { return false; }
+        if (!this->child_1_->render(display, faces)) { return false; }
+        if (!this->child_2_->render(display, faces)) { return false; }
     }
 
     return true;
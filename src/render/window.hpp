@@ -5,9 +5,8 @@
 #include <memory>
 #include <vector>
 
-#include <sol/forward.hpp>
-
 struct Display;
+struct FaceRegistry;
 struct Viewport;
 
 /// Windows are elements in a tiling tree. They represent either a node containing two children or a leaf containing a
@@ -42,7 +41,7 @@ public:
     void resize(std::size_t x, std::size_t y, std::size_t w, std::size_t h) const;
     /// Propagates render events through the tree and applies them on leaves.
     [[nodiscard]]
-    auto render(Display& display, const sol::protected_function& resolve_face) const -> bool;
+    auto render(Display& display, FaceRegistry& faces) const -> bool;
 
     /// Finds the parent node of a specific Viewport.
     [[nodiscard]]
@@ -75,10 +75,10 @@ void Workspace::resize(const std::size_t width, const std::size_t height) {
     if (this->root_) { this->root_->resize(0, 0, width, height); }
 }
 
-auto Workspace::render(Display& display, const sol::protected_function& resolve_face) const -> bool {
+auto Workspace::render(Display& display, FaceRegistry& faces) const -> bool {
     if (!this->root_) { return false; }
 
-    return this->root_->render(display, resolve_face);
+    return this->root_->render(display, faces);
 }
 
 void Workspace::enter_mini_buffer(uv_timer_t& timer) {
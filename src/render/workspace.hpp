@@ -11,6 +11,7 @@
 
 enum struct Direction : std::uint8_t;
 struct Display;
+struct FaceRegistry;
 struct Viewport;
 struct Window;
 
@@ -54,7 +55,7 @@ public:
     void resize(std::size_t width, std::size_t height);
     /// Propagates render events through the tree and applies them on leaves.
     [[nodiscard]]
-    auto render(Display& display, const sol::protected_function& resolve_face) const -> bool;
+    auto render(Display& display, FaceRegistry& faces) const -> bool;
 
     void enter_mini_buffer(uv_timer_t& timer);
     void exit_mini_buffer();
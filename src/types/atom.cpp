@@ -0,0 +1,48 @@
+#include "atom.hpp"
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "../util/assert.hpp"
+
+namespace {
+    struct AtomTable {
+    public:
+        /// Interned strings. A deque never moves its elements, keeping the views into them valid.
+        std::deque<std::string> names_{};
+        std::unordered_map<std::string_view, std::uint32_t> ids_{};
+
+    public:
+        AtomTable() { this->intern(""); }
+
+        auto intern(const std::string_view name) -> std::uint32_t {
+            if (const auto it = this->ids_.find(name); it != this->ids_.end()) { return it->second; }
+
+            const auto id = static_cast<std::uint32_t>(this->names_.size());
+            this->ids_.emplace(this->names_.emplace_back(name), id);
+
+            return id;
+        }
+    };
+
+    /// The table is created on first use, making it safe to intern during static initialization.
+    auto table() -> AtomTable& {
+        static AtomTable table{};
+        return table;
+    }
+} // namespace
+
+Atom::Atom(const std::string_view name) : id_{table().intern(name)} {}
+
+auto Atom::from(const std::variant<std::string_view, Atom>& key) -> Atom {
+    if (const auto* const atom = std::get_if<Atom>(&key); atom) { return *atom; }
+
+    return Atom{std::get<std::string_view>(key)};
+}
+
+auto Atom::name() const -> std::string_view {
+    ASSERT(this->id_ < table().names_.size(), "");
+
+    return table().names_[this->id_];
+}
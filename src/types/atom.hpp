@@ -0,0 +1,61 @@
+#ifndef ATOM_HPP_
+#define ATOM_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <variant>
+
+/// Atoms are interned strings identified by an integer. Interning the same string always yields the same Atom,
+/// comparing and hashing Atoms never touches the string. Interning only allocates the first time a string is seen.
+///
+/// Atoms are never freed, they should only be created for a bounded set of strings like property keys.
+struct Atom {
+public:
+    std::uint32_t id_{0};
+
+public:
+    /// Creates the Atom of the empty string.
+    Atom() = default;
+    /// Interns the string.
+    explicit Atom(std::string_view name);
+
+    /// Gets the interned string. It stays valid for the lifetime of the program.
+    [[nodiscard]]
+    auto name() const -> std::string_view;
+
+    [[nodiscard]]
+    auto operator==(const Atom& rhs) const -> bool = default;
+
+    /// Interns the string or passes the Atom through.
+    [[nodiscard]]
+    static auto from(const std::variant<std::string_view, Atom>& key) -> Atom;
+};
+
+/// A string or an already interned Atom. Lua may pass either as a key.
+using AtomKey = std::variant<std::string_view, Atom>;
+
+template<>
+struct std::hash<Atom> {
+    auto operator()(const Atom atom) const noexcept -> std::size_t { return atom.id_; }
+};
+
+/// Atoms of keys used by the core.
+namespace atoms {
+    inline const Atom REPLACEMENT{"replacement"};
+    inline const Atom ANSI_FG{"ansi.fg"};
+    inline const Atom ANSI_BG{"ansi.bg"};
+    inline const Atom ANSI_STYLE{"ansi.style"};
+
+    /// Faces used by the core.
+    inline const Atom DEFAULT_FACE{"default"};
+    inline const Atom GUTTER_FACE{"gutter"};
+    inline const Atom CURRENT_LINE_FACE{"current_line"};
+    inline const Atom WS_FACE{"ws"};
+    inline const Atom NL_FACE{"nl"};
+    inline const Atom TAB_FACE{"tab"};
+    inline const Atom MODE_LINE_FACE{"mode_line"};
+} // namespace atoms
+
+#endif
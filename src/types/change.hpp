@@ -0,0 +1,14 @@
+#ifndef CHANGE_HPP_
+#define CHANGE_HPP_
+
+#include <cstddef>
+
+/// Changes record that removed bytes at pos of a Document were replaced by inserted bytes.
+struct Change {
+public:
+    std::size_t pos_;
+    std::size_t removed_;
+    std::size_t inserted_;
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef EDIT_HPP_
+#define EDIT_HPP_
+
+#include <cstddef>
+#include <string>
+
+/// Edits replace the bytes from start to end (exclusive) of a Document with text.
+struct Edit {
+public:
+    std::size_t start_;
+    std::size_t end_;
+    std::string text_;
+};
+
+#endif
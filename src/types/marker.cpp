@@ -0,0 +1,13 @@
+#include "marker.hpp"
+
+void Marker::update_on_insert(const std::size_t pos, const std::size_t len) {
+    if (this->pos_ > pos || (this->pos_ == pos && this->gravity_ == Gravity::RIGHT)) { this->pos_ += len; }
+}
+
+void Marker::update_on_remove(const std::size_t start, const std::size_t end) {
+    if (this->pos_ >= end) {
+        this->pos_ -= end - start;
+    } else if (this->pos_ > start) {
+        this->pos_ = start;
+    }
+}
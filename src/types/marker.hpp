@@ -0,0 +1,26 @@
+#ifndef MARKER_HPP_
+#define MARKER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+/// Gravity decides on which side of text inserted at a Marker's position the Marker ends up.
+enum struct Gravity : std::uint8_t { LEFT, RIGHT };
+
+/// Markers are byte positions in a Document that move with its edits. A Marker inside removed text moves to the start
+/// of the removal.
+///
+/// Markers are created by and registered with a Document, they are updated for as long as they are referenced.
+struct Marker {
+public:
+    std::size_t pos_{0};
+    Gravity gravity_{Gravity::LEFT};
+
+public:
+    /// Updates the position after insertion.
+    void update_on_insert(std::size_t pos, std::size_t len);
+    /// Updates the position after removal.
+    void update_on_remove(std::size_t start, std::size_t end);
+};
+
+#endif
@@ -3,17 +3,20 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <string>
 
-/// Operations are insertions or removals of text in a Document.
+/// Operations are insertions or removals of text in a Document, or batches of Edits.
 struct Operation {
 public:
-    enum struct Type : std::uint8_t { INSERT, REMOVE };
+    enum struct Type : std::uint8_t { INSERT, REMOVE, EDITS };
 
 public:
     Type type_;
     std::size_t pos_;
-    std::string data_;
+    /// Offset of the inserted or removed text in the data of its Transaction. For EDITS, the index of the first Edit
+    /// in the edits of its Transaction.
+    std::size_t offset_{0};
+    /// Length of the inserted or removed text. For EDITS, the count of Edits.
+    std::size_t len_{0};
 };
 
 #endif
@@ -2,9 +2,9 @@
 #define TEXT_PROPERTY_HPP_
 
 #include <cstddef>
-#include <string>
 
-#include <sol/object.hpp>
+#include "atom.hpp"
+#include "property_value.hpp"
 
 /// Properties are a key-value metadata storage attached to a text range in a Document. The bounds are interpreted as
 /// byte indices.
@@ -16,8 +16,8 @@ public:
     std::size_t start_;
     std::size_t end_;
 
-    std::string key_;
-    sol::object value_;
+    Atom key_;
+    PropertyValue value_;
 
 public:
     [[nodiscard]]
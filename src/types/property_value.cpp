@@ -0,0 +1,78 @@
+#include "property_value.hpp"
+
+PropertyValue::PropertyValue(const Atom atom) : value_{atom} {}
+PropertyValue::PropertyValue(const Face& face) : value_{face} {}
+
+PropertyValue::PropertyValue(const sol::object& value, const bool intern) {
+    switch (value.get_type()) {
+        case sol::type::none:
+        case sol::type::lua_nil: break;
+        case sol::type::boolean: this->value_ = value.as<bool>(); break;
+        case sol::type::number: {
+            // Only integers are stored natively, floats would lose their subtype on the way back to Lua.
+            auto* const lua = value.lua_state();
+            value.push(lua);
+            if (lua_isinteger(lua, -1) != 0) {
+                this->value_ = static_cast<std::int64_t>(lua_tointeger(lua, -1));
+            } else {
+                this->value_ = value;
+            }
+            lua_pop(lua, 1);
+            break;
+        }
+        case sol::type::string: {
+            const auto str = value.as<std::string_view>();
+            if (intern) {
+                this->value_ = Atom{str};
+            } else {
+                this->value_ = std::string{str};
+            }
+            break;
+        }
+        case sol::type::userdata:
+            if (value.is<Face>()) {
+                this->value_ = value.as<Face>();
+            } else if (value.is<Atom>()) {
+                this->value_ = value.as<Atom>();
+            } else {
+                this->value_ = value;
+            }
+            break;
+        default: this->value_ = value; break;
+    }
+}
+
+auto PropertyValue::empty() const -> bool { return std::holds_alternative<std::monostate>(this->value_); }
+
+auto PropertyValue::face() const -> const Face* { return std::get_if<Face>(&this->value_); }
+
+auto PropertyValue::string() const -> std::optional<std::string_view> {
+    if (const auto* const atom = std::get_if<Atom>(&this->value_); atom) { return atom->name(); }
+    if (const auto* const str = std::get_if<std::string>(&this->value_); str) { return *str; }
+    if (const auto* const obj = std::get_if<sol::object>(&this->value_); obj && obj->get_type() == sol::type::string) {
+        return obj->as<std::string_view>();
+    }
+
+    return std::nullopt;
+}
+
+auto PropertyValue::atom() const -> std::optional<Atom> {
+    if (const auto* const atom = std::get_if<Atom>(&this->value_); atom) { return *atom; }
+
+    return std::nullopt;
+}
+
+auto PropertyValue::to_lua(lua_State* lua) const -> sol::object {
+    if (const auto* const atom = std::get_if<Atom>(&this->value_); atom) { return sol::make_object(lua, atom->name()); }
+    if (const auto* const boolean = std::get_if<bool>(&this->value_); boolean) {
+        return sol::make_object(lua, *boolean);
+    }
+    if (const auto* const str = std::get_if<std::string>(&this->value_); str) { return sol::make_object(lua, *str); }
+    if (const auto* const integer = std::get_if<std::int64_t>(&this->value_); integer) {
+        return sol::make_object(lua, *integer);
+    }
+    if (const auto* const face = std::get_if<Face>(&this->value_); face) { return sol::make_object(lua, *face); }
+    if (const auto* const obj = std::get_if<sol::object>(&this->value_); obj) { return *obj; }
+
+    return sol::lua_nil;
+}
@@ -0,0 +1,51 @@
+#ifndef PROPERTY_VALUE_HPP_
+#define PROPERTY_VALUE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include <sol/object.hpp>
+
+#include "atom.hpp"
+#include "face.hpp"
+
+/// PropertyValues store the value of a Property. Common values (strings, booleans, integers and Faces) are stored
+/// natively, all other Lua values are kept as a reference into the Lua registry.
+///
+/// Atoms are never freed, so strings are only interned if they are passed as an Atom or name a face. All other strings
+/// are copied.
+struct PropertyValue {
+public:
+    std::variant<std::monostate, Atom, bool, std::int64_t, std::string, Face, sol::object> value_{};
+
+public:
+    /// Creates the nil value.
+    PropertyValue() = default;
+    explicit PropertyValue(Atom atom);
+    explicit PropertyValue(const Face& face);
+    /// Converts a Lua value, storing it natively if possible. Strings are only interned if intern is set.
+    PropertyValue(const sol::object& value, bool intern);
+
+    /// Checks if the value is nil.
+    [[nodiscard]]
+    auto empty() const -> bool;
+    /// Gets the Face if the value is one.
+    [[nodiscard]]
+    auto face() const -> const Face*;
+    /// Gets the string if the value is one. The string stays valid as long as the value exists.
+    [[nodiscard]]
+    auto string() const -> std::optional<std::string_view>;
+    /// Gets the Atom if the value is an interned string.
+    [[nodiscard]]
+    auto atom() const -> std::optional<Atom>;
+
+    /// Converts the value to a Lua value.
+    [[nodiscard]]
+    auto to_lua(lua_State* lua) const -> sol::object;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "transaction.hpp"
+
+#include "../util/assert.hpp"
+
+// The text of the last INSERT or REMOVE Operation is always at the end of the data, which allows growing and shrinking
+// it in place.
+
+void Transaction::record_insert(const std::size_t pos, const std::string_view data) {
+    if (data.empty()) { return; }
+
+    // Insertions into or directly behind the previous insertion extend it.
+    if (!this->operations_.empty()) {
+        auto& last = this->operations_.back();
+        if (last.type_ == Operation::Type::INSERT && last.pos_ <= pos && pos <= last.pos_ + last.len_) {
+            this->data_.insert(last.offset_ + (pos - last.pos_), data);
+            last.len_ += data.size();
+            return;
+        }
+    }
+
+    this->operations_.push_back(
+        Operation{.type_ = Operation::Type::INSERT, .pos_ = pos, .offset_ = this->data_.size(), .len_ = data.size()});
+    this->data_.append(data);
+}
+
+void Transaction::record_remove(const std::size_t pos, const std::string_view data) {
+    if (data.empty()) { return; }
+
+    if (!this->operations_.empty()) {
+        auto& last = this->operations_.back();
+
+        // Removing previously inserted text shrinks the insertion, e.g. when correcting a typo.
+        if (last.type_ == Operation::Type::INSERT && last.pos_ <= pos && pos + data.size() <= last.pos_ + last.len_) {
+            this->data_.erase(last.offset_ + (pos - last.pos_), data.size());
+            last.len_ -= data.size();
+            if (last.len_ == 0) { this->operations_.pop_back(); }
+            return;
+        }
+
+        // Removing directly before (backspace) or at (delete) the previous removal extends it.
+        if (last.type_ == Operation::Type::REMOVE && pos + data.size() == last.pos_) {
+            this->data_.insert(last.offset_, data);
+            last.pos_ = pos;
+            last.len_ += data.size();
+            return;
+        }
+        if (last.type_ == Operation::Type::REMOVE && pos == last.pos_) {
+            this->data_.append(data);
+            last.len_ += data.size();
+            return;
+        }
+    }
+
+    this->operations_.push_back(
+        Operation{.type_ = Operation::Type::REMOVE, .pos_ = pos, .offset_ = this->data_.size(), .len_ = data.size()});
+    this->data_.append(data);
+}
+
+void Transaction::record_edits(
+    const std::size_t pos, const std::vector<Edit>& edits, const std::vector<Edit>& inverse) {
+    ASSERT(edits.size() == inverse.size(), "");
+
+    this->operations_.push_back(
+        Operation{
+            .type_ = Operation::Type::EDITS, .pos_ = pos, .offset_ = this->edits_.size(), .len_ = edits.size()});
+
+    for (const auto* batch: {&edits, &inverse}) {
+        for (const auto& edit: *batch) {
+            this->edits_.push_back(
+                RecordedEdit{
+                    .start_ = edit.start_,
+                    .end_ = edit.end_,
+                    .offset_ = this->data_.size(),
+                    .len_ = edit.text_.size()});
+            this->data_.append(edit.text_);
+        }
+    }
+}
+
+void Transaction::finish() {
+    this->operations_.shrink_to_fit();
+    this->data_.shrink_to_fit();
+    this->edits_.shrink_to_fit();
+
+    this->size_ = sizeof(Transaction) + this->operations_.capacity() * sizeof(Operation) + this->data_.capacity() +
+                  this->edits_.capacity() * sizeof(RecordedEdit);
+}
+
+auto Transaction::text(const Operation& operation) const -> std::string_view {
+    return std::string_view{this->data_}.substr(operation.offset_, operation.len_);
+}
+
+auto Transaction::edits(const Operation& operation, const bool inverse) const -> std::vector<Edit> {
+    ASSERT(operation.type_ == Operation::Type::EDITS, "");
+
+    const auto first = operation.offset_ + (inverse ? operation.len_ : 0);
+
+    std::vector<Edit> edits{};
+    edits.reserve(operation.len_);
+    for (auto idx = first; idx < first + operation.len_; idx += 1) {
+        const auto& edit = this->edits_[idx];
+        edits.push_back(
+            Edit{
+                .start_ = edit.start_,
+                .end_ = edit.end_,
+                .text_ = std::string{std::string_view{this->data_}.substr(edit.offset_, edit.len_)}});
+    }
+
+    return edits;
+}
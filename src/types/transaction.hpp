@@ -1,16 +1,55 @@
 #ifndef TRANSACTION_HPP_
 #define TRANSACTION_HPP_
 
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "edit.hpp"
 #include "operation.hpp"
 
 /// Transactions group Operations on a Document into a block.
+///
+/// The texts of all insertions, removals and Edits are stored back to back in a single buffer. Consecutive insertions
+/// and removals (e.g. typing or deleting characters) are merged into a single Operation while being recorded.
 struct Transaction {
+public:
+    /// An Edit of an EDITS Operation, its text is stored in the data.
+    struct RecordedEdit {
+    public:
+        std::size_t start_;
+        std::size_t end_;
+        std::size_t offset_;
+        std::size_t len_;
+    };
+
 public:
     std::vector<Operation> operations_{};
+    /// Texts of all insertions, removals and Edits.
+    std::string data_{};
+    /// Edits of all EDITS Operations. The Edits of an Operation are followed by the Edits reverting it.
+    std::vector<RecordedEdit> edits_{};
     std::size_t point_before_{0UZ};
     std::size_t point_after_{0UZ};
+    /// Approximate memory used by the Transaction, computed once it is finished.
+    std::size_t size_{0UZ};
+
+public:
+    /// Records inserting data at pos.
+    void record_insert(std::size_t pos, std::string_view data);
+    /// Records removing data at pos.
+    void record_remove(std::size_t pos, std::string_view data);
+    /// Records applying edits, inverse reverting them.
+    void record_edits(std::size_t pos, const std::vector<Edit>& edits, const std::vector<Edit>& inverse);
+    /// Releases unused memory and computes the size of the Transaction.
+    void finish();
+
+    /// Gets the text inserted or removed by an Operation of this Transaction.
+    [[nodiscard]]
+    auto text(const Operation& operation) const -> std::string_view;
+    /// Gets the Edits applied by an EDITS Operation of this Transaction or, if inverse is set, the Edits reverting it.
+    [[nodiscard]]
+    auto edits(const Operation& operation, bool inverse) const -> std::vector<Edit>;
 };
 
 #endif
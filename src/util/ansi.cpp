@@ -1,11 +1,35 @@
 #include "ansi.hpp"
 
+#include <array>
+#include <charconv>
 #include <utility>
 
 #include "../types/rgb.hpp"
 #include "assert.hpp"
 
 namespace ansi {
+    namespace {
+        void append_num(std::string& buff, const std::size_t num) {
+            // Twenty since max { size_t } = 18446744073709551615.
+            constexpr auto num_len{20};
+
+            std::array<char, num_len> str{};
+            if (auto [ptr, ec] = std::to_chars(str.data(), str.data() + num_len, num); ec == std::errc()) {
+                buff.append(std::string_view(str.data(), ptr - str.data()));
+            } else {
+                std::unreachable();
+            }
+        }
+
+        void append_rgb(std::string& buff, const Rgb rgb) {
+            append_num(buff, rgb.r_);
+            buff.push_back(';');
+            append_num(buff, rgb.g_);
+            buff.push_back(';');
+            append_num(buff, rgb.b_);
+        }
+    } // namespace
+
     void enable_kitty_protocol(std::string& buff) { buff.append("\x1B[>1u"); }
     void disable_kitty_protocol(std::string& buff) { buff.append("\x1B[<u"); }
 
@@ -35,39 +59,40 @@ namespace ansi {
         buff.push_back('H');
     }
 
-    void rgb(std::string& buff, const Rgb rgb, const bool foreground) {
-        // Five since max { uint16_t } = 65535.
-        constexpr auto num_len{5};
-
+    void move_forward(std::string& buff, const std::size_t n) {
         buff.append("\x1B[");
-        if (foreground) {
-            buff.append("38;2;");
-        } else {
-            buff.append("48;2;");
-        }
+        append_num(buff, n);
+        buff.push_back('C');
+    }
 
-        std::array<char, num_len> r_str{};
-        if (auto [ptr, ec] = std::to_chars(r_str.data(), r_str.data() + num_len, rgb.r_); ec == std::errc()) {
-            buff.append(std::string_view(r_str.data(), ptr - r_str.data()));
-        } else {
-            std::unreachable();
-        }
-        buff.push_back(';');
+    void style(
+        std::string& buff, const std::optional<Rgb> fg, const std::optional<Rgb> bg, const std::optional<bool> bold,
+        const std::optional<bool> italic, const std::optional<bool> underline,
+        const std::optional<bool> strikethrough) {
+        if (!fg && !bg && !bold && !italic && !underline && !strikethrough) { return; }
 
-        std::array<char, num_len> g_str{};
-        if (auto [ptr, ec] = std::to_chars(g_str.data(), g_str.data() + num_len, rgb.g_); ec == std::errc()) {
-            buff.append(std::string_view(g_str.data(), ptr - g_str.data()));
-        } else {
-            std::unreachable();
-        }
-        buff.push_back(';');
+        buff.append("\x1B[");
 
-        std::array<char, num_len> b_str{};
-        if (auto [ptr, ec] = std::to_chars(b_str.data(), b_str.data() + num_len, rgb.b_); ec == std::errc()) {
-            buff.append(std::string_view(b_str.data(), ptr - b_str.data()));
-        } else {
-            std::unreachable();
+        // Parameters are separated by semicolons, the first one is written without.
+        auto first{true};
+        auto param = [&](const std::string_view str) -> void {
+            if (!first) { buff.push_back(';'); }
+            buff.append(str);
+            first = false;
+        };
+
+        if (fg) {
+            param("38;2;");
+            append_rgb(buff, *fg);
+        }
+        if (bg) {
+            param("48;2;");
+            append_rgb(buff, *bg);
         }
+        if (bold) { param(*bold ? "1" : "22"); }
+        if (italic) { param(*italic ? "3" : "23"); }
+        if (underline) { param(*underline ? "4" : "24"); }
+        if (strikethrough) { param(*strikethrough ? "9" : "29"); }
 
         buff.push_back('m');
     }
@@ -96,13 +121,40 @@ namespace ansi {
     void hide_cursor(std::string& buff) { buff.append("\x1B[?25l"); }
     void show_cursor(std::string& buff) { buff.append("\x1B[?25h"); }
 
+    void query_synchronized_output(std::string& buff) { buff.append("\x1B[?2026$p"); }
+    void begin_synchronized_update(std::string& buff) { buff.append("\x1B[?2026h"); }
+    void end_synchronized_update(std::string& buff) { buff.append("\x1B[?2026l"); }
+
     void alt_screen(std::string& buff) { buff.append("\x1B[?1049h"); }
     void main_screen(std::string& buff) { buff.append("\x1B[?1049l"); }
 
     void clear(std::string& buff) { buff.append("\x1B[2J"); }
+    void erase_chars(std::string& buff, const std::size_t n) {
+        buff.append("\x1B[");
+        append_num(buff, n);
+        buff.push_back('X');
+    }
+    void erase_line(std::string& buff) { buff.append("\x1B[K"); }
 
-    void bold(std::string& buff, const bool set) { buff.append(set ? "\x1B[1m" : "\x1B[22m"); }
-    void italic(std::string& buff, const bool set) { buff.append(set ? "\x1B[3m" : "\x1B[23m"); }
-    void underline(std::string& buff, const bool set) { buff.append(set ? "\x1B[4m" : "\x1B[24m"); }
-    void strikethrough(std::string& buff, const bool set) { buff.append(set ? "\x1B[9m" : "\x1B[29m"); }
+    void scroll_region(std::string& buff, const std::size_t top, const std::size_t bottom) {
+        ASSERT_DEBUG // NOLINT(readability-simplify-boolean-expr)
+            (top > 0 && top <= bottom, "Scroll region must be inside screen space.");
+
+        buff.append("\x1B[");
+        append_num(buff, top);
+        buff.push_back(';');
+        append_num(buff, bottom);
+        buff.push_back('r');
+    }
+    void reset_scroll_region(std::string& buff) { buff.append("\x1B[r"); }
+    void scroll_up(std::string& buff, const std::size_t n) {
+        buff.append("\x1B[");
+        append_num(buff, n);
+        buff.push_back('S');
+    }
+    void scroll_down(std::string& buff, const std::size_t n) {
+        buff.append("\x1B[");
+        append_num(buff, n);
+        buff.push_back('T');
+    }
 } // namespace ansi
@@ -1,7 +1,9 @@
 #ifndef ANSI_HPP_
 #define ANSI_HPP_
 
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <string>
 
 struct Rgb;
@@ -24,9 +26,13 @@ namespace ansi {
 
     /// Moves the terminal cursor to a row and column (one indexed).
     void move_to(std::string& buff, std::uint16_t row, std::uint16_t col);
+    /// Moves the terminal cursor n columns to the right.
+    void move_forward(std::string& buff, std::size_t n);
 
-    /// Sets the RGB color value for the foreground (default) or background.
-    void rgb(std::string& buff, Rgb rgb, bool foreground = true);
+    /// Sets all given colors and character styles in a single sequence. Nothing is written if none are given.
+    void style(
+        std::string& buff, std::optional<Rgb> fg, std::optional<Rgb> bg, std::optional<bool> bold,
+        std::optional<bool> italic, std::optional<bool> underline, std::optional<bool> strikethrough);
     /// Sets the cursor style.
     void cursor(std::string& buff, CursorStyle style);
     /// Resets all style options to the terminal's defaults.
@@ -37,6 +43,13 @@ namespace ansi {
     /// Shows the terminal cursor.
     void show_cursor(std::string& buff);
 
+    /// Asks the terminal to report if it supports synchronized output.
+    void query_synchronized_output(std::string& buff);
+    /// Holds back drawing until the update ends, so the terminal never shows half-written frames.
+    void begin_synchronized_update(std::string& buff);
+    /// Draws everything written since the update began.
+    void end_synchronized_update(std::string& buff);
+
     /// Enables the alternate screen.
     void alt_screen(std::string& buff);
     /// Returns to the main screen.
@@ -44,15 +57,19 @@ namespace ansi {
 
     /// Clears the terminal.
     void clear(std::string& buff);
+    /// Erases n characters starting at the cursor with the current background color without moving the cursor.
+    void erase_chars(std::string& buff, std::size_t n);
+    /// Erases the line from the cursor to its end with the current background color.
+    void erase_line(std::string& buff);
 
-    /// Set or unset bold charcter style.
-    void bold(std::string& buff, bool set);
-    /// Set or unset italic charcter style.
-    void italic(std::string& buff, bool set);
-    /// Set or unset underline charcter style.
-    void underline(std::string& buff, bool set);
-    /// Set or unset strikethrough charcter style.
-    void strikethrough(std::string& buff, bool set);
+    /// Restricts scrolling to the rows from top to bottom (one indexed, inclusive). Moves the cursor to the top left.
+    void scroll_region(std::string& buff, std::size_t top, std::size_t bottom);
+    /// Lifts the scrolling restriction. Moves the cursor to the top left.
+    void reset_scroll_region(std::string& buff);
+    /// Scrolls the content of the scroll region up by n rows, exposing blank rows at the bottom.
+    void scroll_up(std::string& buff, std::size_t n);
+    /// Scrolls the content of the scroll region down by n rows, exposing blank rows at the top.
+    void scroll_down(std::string& buff, std::size_t n);
 } // namespace ansi
 
 #endif
@@ -1,9 +1,7 @@
 #include "ansi_text_stream.hpp"
 
-#include <sol/object.hpp>
-
 #include "../document.hpp"
-#include "../editor.hpp"
+#include "../types/atom.hpp"
 #include "../types/face.hpp"
 #include "utf8.hpp"
 
@@ -78,10 +76,10 @@ auto AnsiTextStream::flush(std::size_t pos) -> std::size_t {
 
 void AnsiTextStream::process_sgr(const std::vector<int>& codes) {
     if (codes.empty()) {
-        this->fg_ = sol::object{sol::lua_nil};
-        this->bg_ = sol::object{sol::lua_nil};
+        this->fg_ = PropertyValue{};
+        this->bg_ = PropertyValue{};
         this->style_mask_ = std::to_underlying(StyleMask::NONE);
-        this->style_ = sol::object{sol::lua_nil};
+        this->style_ = PropertyValue{};
 
         return;
     }
@@ -92,10 +90,10 @@ void AnsiTextStream::process_sgr(const std::vector<int>& codes) {
         switch (code) {
             // Reset.
             case 0:
-                this->fg_ = sol::object{sol::lua_nil};
-                this->bg_ = sol::object{sol::lua_nil};
+                this->fg_ = PropertyValue{};
+                this->bg_ = PropertyValue{};
                 this->style_mask_ = std::to_underlying(StyleMask::NONE);
-                this->style_ = sol::object{sol::lua_nil};
+                this->style_ = PropertyValue{};
                 break;
 
             // Set style.
@@ -135,8 +133,8 @@ void AnsiTextStream::process_sgr(const std::vector<int>& codes) {
                 break;
 
             // Reset colors.
-            case 39: this->fg_ = sol::object{sol::lua_nil}; break;
-            case 49: this->bg_ = sol::object{sol::lua_nil}; break;
+            case 39: this->fg_ = PropertyValue{}; break;
+            case 49: this->bg_ = PropertyValue{}; break;
 
             // True colors.
             case 38:
@@ -212,12 +210,12 @@ void AnsiTextStream::process_sgr(const std::vector<int>& codes) {
 auto AnsiTextStream::apply_styles(const std::size_t start, const std::size_t stop) -> void {
     if (start == stop) { return; }
 
-    if (this->fg_ != sol::lua_nil) { this->doc_->add_text_property(start, stop, "ansi.fg", this->fg_); }
-    if (this->bg_ != sol::lua_nil) { this->doc_->add_text_property(start, stop, "ansi.bg", this->bg_); }
-    if (this->style_ != sol::lua_nil) { this->doc_->add_text_property(start, stop, "ansi.style", this->style_); }
+    if (!this->fg_.empty()) { this->doc_->add_text_property(start, stop, atoms::ANSI_FG, this->fg_); }
+    if (!this->bg_.empty()) { this->doc_->add_text_property(start, stop, atoms::ANSI_BG, this->bg_); }
+    if (!this->style_.empty()) { this->doc_->add_text_property(start, stop, atoms::ANSI_STYLE, this->style_); }
 }
 
-auto AnsiTextStream::get_fg(const std::size_t code) -> sol::object {
+auto AnsiTextStream::get_fg(const std::size_t code) -> PropertyValue {
     if (const auto it{this->fg_cache_.find(code)}; it != this->fg_cache_.end()) { return it->second; }
 
     std::string face{};
@@ -242,15 +240,15 @@ auto AnsiTextStream::get_fg(const std::size_t code) -> sol::object {
         case 96: face = "ansi.fg.bright_cyan"; break;
         case 97: face = "ansi.fg.bright_white"; break;
 
-        default: return sol::lua_nil;
+        default: return PropertyValue{};
     }
 
-    auto obj{sol::make_object(Editor::instance()->lua_, face)};
-    this->fg_cache_[code] = obj;
-    return obj;
+    const PropertyValue value{Atom{face}};
+    this->fg_cache_[code] = value;
+    return value;
 }
 
-auto AnsiTextStream::get_bg(const std::size_t code) -> sol::object {
+auto AnsiTextStream::get_bg(const std::size_t code) -> PropertyValue {
     if (const auto it{this->bg_cache_.find(code)}; it != this->bg_cache_.end()) { return it->second; }
 
     std::string face;
@@ -275,52 +273,36 @@ auto AnsiTextStream::get_bg(const std::size_t code) -> sol::object {
         case 106: face = "ansi.bg.bright_cyan"; break;
         case 107: face = "ansi.bg.bright_white"; break;
 
-        default: return sol::lua_nil;
+        default: return PropertyValue{};
     }
 
-    auto obj{sol::make_object(Editor::instance()->lua_, face)};
-    this->bg_cache_[code] = obj;
-    return obj;
+    const PropertyValue value{Atom{face}};
+    this->bg_cache_[code] = value;
+    return value;
 }
 
-auto AnsiTextStream::get_style() -> sol::object {
-    if (this->style_mask_ == std::to_underlying(StyleMask::NONE)) { return sol::lua_nil; }
-
-    if (this->style_cache_[this->style_mask_] == sol::lua_nil) {
-        Face f{};
+auto AnsiTextStream::get_style() const -> PropertyValue {
+    if (this->style_mask_ == std::to_underlying(StyleMask::NONE)) { return PropertyValue{}; }
 
-        if ((this->style_mask_ & std::to_underlying(StyleMask::BOLD)) != 0) { f.bold_ = true; }
-        if ((this->style_mask_ & std::to_underlying(StyleMask::ITALIC)) != 0) { f.italic_ = true; }
-        if ((this->style_mask_ & std::to_underlying(StyleMask::UNDERLINE)) != 0) { f.underline_ = true; }
-        if ((this->style_mask_ & std::to_underlying(StyleMask::STRIKETHROUGH)) != 0) { f.strikethrough_ = true; }
+    Face face{};
+    if ((this->style_mask_ & std::to_underlying(StyleMask::BOLD)) != 0) { face.bold_ = true; }
+    if ((this->style_mask_ & std::to_underlying(StyleMask::ITALIC)) != 0) { face.italic_ = true; }
+    if ((this->style_mask_ & std::to_underlying(StyleMask::UNDERLINE)) != 0) { face.underline_ = true; }
+    if ((this->style_mask_ & std::to_underlying(StyleMask::STRIKETHROUGH)) != 0) { face.strikethrough_ = true; }
 
-        this->style_cache_[this->style_mask_] = sol::make_object(Editor::instance()->lua_, f);
-    }
-    return this->style_cache_[this->style_mask_];
+    return PropertyValue{face};
 }
 
-auto AnsiTextStream::get_rgb_fg(uint8_t r, uint8_t g, uint8_t b) -> sol::object {
-    auto key{(static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b};
-
-    if (const auto it{this->rgb_fg_cache_.find(key)}; it != this->rgb_fg_cache_.end()) { return it->second; }
-
+auto AnsiTextStream::get_rgb_fg(const uint8_t r, const uint8_t g, const uint8_t b) -> PropertyValue {
     Face face{};
     face.fg_ = Rgb{.r_ = r, .g_ = g, .b_ = b};
 
-    auto obj{sol::make_object(Editor::instance()->lua_, face)};
-    this->rgb_fg_cache_[key] = obj;
-    return obj;
+    return PropertyValue{face};
 }
 
-auto AnsiTextStream::get_rgb_bg(uint8_t r, uint8_t g, uint8_t b) -> sol::object {
-    uint32_t key = (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b;
-
-    if (const auto it = this->rgb_bg_cache_.find(key); it != this->rgb_bg_cache_.end()) { return it->second; }
-
+auto AnsiTextStream::get_rgb_bg(const uint8_t r, const uint8_t g, const uint8_t b) -> PropertyValue {
     Face face{};
     face.bg_ = Rgb{.r_ = r, .g_ = g, .b_ = b};
 
-    auto obj{sol::make_object(Editor::instance()->lua_, face)};
-    this->rgb_bg_cache_[key] = obj;
-    return obj;
+    return PropertyValue{face};
 }
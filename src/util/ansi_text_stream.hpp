@@ -4,8 +4,7 @@
 #include <memory>
 #include <string>
 
-#include <sol/object.hpp>
-
+#include "../types/property_value.hpp"
 #include "ansi_parser.hpp"
 
 struct Document;
@@ -31,17 +30,13 @@ private:
     std::size_t curr_pos_{0};
     bool prev_cr_{false};
 
-    sol::object fg_{sol::lua_nil};
-    sol::object bg_{sol::lua_nil};
-    sol::object style_{sol::lua_nil};
+    PropertyValue fg_{};
+    PropertyValue bg_{};
+    PropertyValue style_{};
     uint8_t style_mask_{0};
 
-    std::unordered_map<std::size_t, sol::object> fg_cache_{};
-    std::unordered_map<std::size_t, sol::object> bg_cache_{};
-    std::array<sol::object, 16> style_cache_{};
-
-    std::unordered_map<uint32_t, sol::object> rgb_fg_cache_{};
-    std::unordered_map<uint32_t, sol::object> rgb_bg_cache_{};
+    std::unordered_map<std::size_t, PropertyValue> fg_cache_{};
+    std::unordered_map<std::size_t, PropertyValue> bg_cache_{};
 
 public:
     explicit AnsiTextStream(std::shared_ptr<Document> doc);
@@ -56,12 +51,13 @@ private:
     void process_sgr(const std::vector<int>& codes);
     void apply_styles(std::size_t start, std::size_t stop);
 
-    auto get_fg(std::size_t code) -> sol::object;
-    auto get_bg(std::size_t code) -> sol::object;
-    auto get_style() -> sol::object;
+    auto get_fg(std::size_t code) -> PropertyValue;
+    auto get_bg(std::size_t code) -> PropertyValue;
+    [[nodiscard]]
+    auto get_style() const -> PropertyValue;
 
-    auto get_rgb_fg(uint8_t r, uint8_t g, uint8_t b) -> sol::object;
-    auto get_rgb_bg(uint8_t r, uint8_t g, uint8_t b) -> sol::object;
+    static auto get_rgb_fg(uint8_t r, uint8_t g, uint8_t b) -> PropertyValue;
+    static auto get_rgb_bg(uint8_t r, uint8_t g, uint8_t b) -> PropertyValue;
 };
 
 #endif
@@ -1,8 +1,209 @@
 #include "fs.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <format>
 #include <fstream>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+#include <uv.h>
 
 namespace fs {
+    namespace {
+        /// Maximum count of buffers written at once.
+        constexpr std::size_t MAX_BUFS{1024};
+        /// Maximum length of a buffer, libuv buffer lengths are 32 bit.
+        constexpr std::size_t MAX_BUF_LEN{1UZ << 30U};
+        /// Maximum count of names tried for a temporary file.
+        constexpr std::size_t MAX_TEMP_ATTEMPTS{100};
+
+        /// Maximum count of files mapped at once. Further files are read instead.
+        constexpr std::size_t MAX_MAPPINGS{64};
+        /// Files modified more recently are likely still being written and are not mapped.
+        constexpr std::chrono::seconds MIN_MAPPED_AGE{5};
+
+        /// Makes the names of temporary files unique within the process.
+        std::atomic<std::size_t> temp_counter{0};
+
+        /// A live mapping as seen by the SIGBUS handler. Only lock-free atomics are accessed from the handler.
+        struct MappingSlot {
+        public:
+            /// Start of the mapping, zero if the slot is free.
+            std::atomic<std::uintptr_t> start_{0};
+            std::atomic<std::size_t> size_{0};
+            std::atomic<bool> truncated_{false};
+        };
+
+        std::array<MappingSlot, MAX_MAPPINGS> mapping_slots{};
+        std::once_flag sigbus_handler_installed{};
+        std::size_t page_size{0};
+
+        /// Magic numbers of network and userspace filesystems (see statfs(2)), whose files are likely to be changed
+        /// behind our back.
+        constexpr std::array<decltype(statfs::f_type), 6> REMOTE_FS_MAGICS{
+            0x6969,     // NFS
+            0x517B,     // SMB
+            0xFF534D42, // CIFS
+            0xFE534D42, // SMB2
+            0x65735546, // FUSE
+            0x01021997, // 9P
+        };
+
+        /// Writes all chunks to a file, retrying partial writes.
+        auto write_chunks(const uv_file fd, const std::vector<std::string_view>& chunks) -> bool {
+            std::vector<uv_buf_t> bufs{};
+            bufs.reserve(chunks.size());
+            for (auto chunk: chunks) {
+                while (!chunk.empty()) {
+                    const auto len = std::min(chunk.size(), MAX_BUF_LEN);
+                    bufs.push_back(uv_buf_init(const_cast<char*>(chunk.data()), static_cast<unsigned int>(len)));
+                    chunk.remove_prefix(len);
+                }
+            }
+
+            uv_fs_t req{};
+            auto idx{0UZ};
+            while (idx < bufs.size()) {
+                const auto count = static_cast<unsigned int>(std::min(bufs.size() - idx, MAX_BUFS));
+                const auto res = uv_fs_write(nullptr, &req, fd, &bufs[idx], count, -1, nullptr);
+                uv_fs_req_cleanup(&req);
+                if (res <= 0) { return false; }
+
+                // Skip the completely written buffers and advance into the partially written one.
+                auto written = static_cast<std::size_t>(res);
+                while (idx < bufs.size() && written >= bufs[idx].len) {
+                    written -= bufs[idx].len;
+                    idx += 1;
+                }
+                if (written > 0) {
+                    bufs[idx].base += written;
+                    bufs[idx].len -= written;
+                }
+            }
+
+            return true;
+        }
+
+        /// Exclusively creates a temporary file next to path and stores its path in tmp. Files of other editors or
+        /// Documents are never clobbered.
+        auto create_temp_file(const std::filesystem::path& path, std::filesystem::path& tmp) -> uv_file {
+            uv_fs_t req{};
+            for (auto attempt{0UZ}; attempt < MAX_TEMP_ATTEMPTS; attempt += 1) {
+                tmp = path;
+                tmp += std::format(".cini-save-{}-{}", getpid(), temp_counter.fetch_add(1));
+
+                const auto fd = uv_fs_open(
+                    nullptr, &req, tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666, nullptr);
+                uv_fs_req_cleanup(&req);
+                if (fd != UV_EEXIST) { return static_cast<uv_file>(fd); }
+            }
+
+            return UV_EEXIST;
+        }
+
+        /// Overwrites a file in place, keeping its inode and thereby all of its hard links.
+        auto overwrite_file(const std::filesystem::path& path, const std::vector<std::string_view>& chunks) -> bool {
+            uv_fs_t req{};
+            const auto fd = static_cast<uv_file>(
+                uv_fs_open(nullptr, &req, path.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC, 0, nullptr));
+            uv_fs_req_cleanup(&req);
+            if (fd < 0) { return false; }
+
+            auto written = write_chunks(fd, chunks);
+            if (written) {
+                written = uv_fs_fsync(nullptr, &req, fd, nullptr) == 0;
+                uv_fs_req_cleanup(&req);
+            }
+            written = uv_fs_close(nullptr, &req, fd, nullptr) == 0 && written;
+            uv_fs_req_cleanup(&req);
+
+            return written;
+        }
+
+        /// Syncs the entries of a directory to disk, making renames within it durable.
+        void sync_directory(const std::filesystem::path& dir) {
+            uv_fs_t req{};
+            const auto fd = static_cast<uv_file>(
+                uv_fs_open(nullptr, &req, dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC, 0, nullptr));
+            uv_fs_req_cleanup(&req);
+            if (fd < 0) { return; }
+
+            uv_fs_fsync(nullptr, &req, fd, nullptr);
+            uv_fs_req_cleanup(&req);
+            uv_fs_close(nullptr, &req, fd, nullptr);
+            uv_fs_req_cleanup(&req);
+        }
+
+        /// Replaces the pages of a truncated file from the faulting one onwards with zeroed memory, so the faulting
+        /// access is retried successfully. Faults outside of mappings keep their default behavior.
+        void handle_sigbus(const int signum, siginfo_t* info, void* /*context*/) {
+            const auto addr = reinterpret_cast<std::uintptr_t>(info->si_addr);
+
+            for (auto& slot: mapping_slots) {
+                const auto start = slot.start_.load();
+                const auto size = slot.size_.load();
+                if (start == 0 || addr < start || addr >= start + size) { continue; }
+
+                const auto page = addr - (addr - start) % page_size;
+                if (mmap(reinterpret_cast<void*>(page), start + size - page, PROT_READ,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+                    break;
+                }
+                slot.truncated_.store(true);
+                return;
+            }
+
+            // Reraise with the default action once the handler returns.
+            std::signal(signum, SIG_DFL);
+        }
+
+        void install_sigbus_handler() {
+            page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+            struct sigaction action{};
+            action.sa_sigaction = handle_sigbus;
+            action.sa_flags = SA_SIGINFO;
+            sigemptyset(&action.sa_mask);
+            sigaction(SIGBUS, &action, nullptr);
+        }
+
+        /// Checks if a file is open for writing by any process. A read lease is refused for such files, it can only be
+        /// taken on own files though, other files are assumed not to be written.
+        auto open_for_writing(const int fd) -> bool {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+            if (fcntl(fd, F_SETLEASE, F_RDLCK) == -1) { return errno == EAGAIN; }
+            fcntl(fd, F_SETLEASE, F_UNLCK); // NOLINT(cppcoreguidelines-pro-type-vararg)
+
+            return false;
+        }
+    } // namespace
+
+    MappedFile::MappedFile(const char* data, const std::size_t size, const std::size_t slot)
+        : data_{data}, size_{size}, slot_{slot} {}
+
+    MappedFile::~MappedFile() {
+        // Hide the mapping from the handler before releasing the slot.
+        auto& slot = mapping_slots[this->slot_];
+        slot.start_.store(0);
+        slot.truncated_.store(false);
+        slot.size_.store(0);
+
+        munmap(const_cast<char*>(this->data_), this->size_);
+    }
+
+    auto MappedFile::view() const -> std::string_view { return std::string_view{this->data_, this->size_}; }
+
+    auto MappedFile::truncated() const -> bool { return mapping_slots[this->slot_].truncated_.load(); }
+
     auto read_file(const std::filesystem::path& path) -> std::optional<std::string> {
         std::ifstream file(path);
 
@@ -17,6 +218,53 @@ namespace fs {
         return buffer;
     }
 
+    auto map_file(const std::filesystem::path& path) -> std::optional<std::shared_ptr<const MappedFile>> {
+        const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        if (fd == -1) { return std::nullopt; }
+
+        struct stat info{};
+        if (fstat(fd, &info) == -1 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+            close(fd);
+            return std::nullopt;
+        }
+
+        // A truncated mapping loses its data, even though the SIGBUS handler keeps the editor alive. Files that are
+        // being written (e.g. logs) or on remote filesystems, which other machines may change at any time, are likely
+        // to be truncated and are not mapped.
+        const auto modified = std::chrono::system_clock::time_point{
+            std::chrono::seconds{info.st_mtim.tv_sec} + std::chrono::nanoseconds{info.st_mtim.tv_nsec}};
+        struct statfs fs_info{};
+        if (std::chrono::system_clock::now() - modified < MIN_MAPPED_AGE || open_for_writing(fd) ||
+            fstatfs(fd, &fs_info) == -1 || std::ranges::count(REMOTE_FS_MAGICS, fs_info.f_type) > 0) {
+            close(fd);
+            return std::nullopt;
+        }
+
+        std::call_once(sigbus_handler_installed, install_sigbus_handler);
+
+        const auto size = static_cast<std::size_t>(info.st_size);
+        // The mapping keeps the file referenced, the file descriptor is not needed afterwards.
+        auto* const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (data == MAP_FAILED) { return std::nullopt; }
+
+        // Claim a free slot, the size is published before the start makes the slot visible to the handler.
+        for (auto idx{0UZ}; idx < mapping_slots.size(); idx += 1) {
+            auto& slot = mapping_slots[idx];
+            if (slot.size_.load() != 0) { continue; }
+
+            auto free = 0UZ;
+            if (!slot.size_.compare_exchange_strong(free, size)) { continue; }
+            slot.start_.store(reinterpret_cast<std::uintptr_t>(data));
+
+            return std::make_shared<const MappedFile>(static_cast<const char*>(data), size, idx);
+        }
+
+        munmap(data, size);
+        return std::nullopt;
+    }
+
     auto
     write_file(const std::filesystem::path& path, const std::string_view contents, const std::ios_base::openmode mode)
         -> bool {
@@ -28,6 +276,61 @@ namespace fs {
         return file.good();
     }
 
+    auto replace_file(
+        const std::filesystem::path& path, const std::vector<std::string_view>& chunks, const bool keep_links) -> bool {
+        // Replace the target of a symlink instead of the symlink itself.
+        std::error_code err{};
+        auto target = std::filesystem::canonical(path, err);
+        if (err) { target = path; }
+
+        // libuv requests without a loop run synchronously.
+        uv_fs_t req{};
+        std::optional<uv_stat_t> info{};
+        if (uv_fs_stat(nullptr, &req, target.c_str(), nullptr) == 0) { info = req.statbuf; }
+        uv_fs_req_cleanup(&req);
+
+        // Renaming a new file over it would detach the file from its other hard links.
+        if (keep_links && info && info->st_nlink > 1) { return overwrite_file(target, chunks); }
+
+        std::filesystem::path tmp{};
+        const auto fd = create_temp_file(target, tmp);
+        if (fd < 0) { return false; }
+
+        auto written = write_chunks(fd, chunks);
+        if (written && info) {
+            // Keeping the owner requires privileges, the file is saved regardless. Changing the owner may clear the
+            // setuid and setgid bits, so it comes before restoring the permissions.
+            uv_fs_fchown(
+                nullptr, &req, fd, static_cast<uv_uid_t>(info->st_uid), static_cast<uv_gid_t>(info->st_gid), nullptr);
+            uv_fs_req_cleanup(&req);
+
+            written = uv_fs_fchmod(nullptr, &req, fd, static_cast<int>(info->st_mode & 07777U), nullptr) == 0;
+            uv_fs_req_cleanup(&req);
+        }
+        if (written) {
+            written = uv_fs_fsync(nullptr, &req, fd, nullptr) == 0;
+            uv_fs_req_cleanup(&req);
+        }
+        written = uv_fs_close(nullptr, &req, fd, nullptr) == 0 && written;
+        uv_fs_req_cleanup(&req);
+
+        // The file is only replaced once the new contents are completely on disk.
+        if (written) {
+            written = uv_fs_rename(nullptr, &req, tmp.c_str(), target.c_str(), nullptr) == 0;
+            uv_fs_req_cleanup(&req);
+        }
+        if (!written) {
+            uv_fs_unlink(nullptr, &req, tmp.c_str(), nullptr);
+            uv_fs_req_cleanup(&req);
+            return false;
+        }
+
+        // The rename itself is only durable once the directory is synced.
+        sync_directory(target.has_parent_path() ? target.parent_path() : std::filesystem::path{"."});
+
+        return true;
+    }
+
     auto absolute(const std::filesystem::path& path) -> std::optional<std::filesystem::path> {
         std::error_code err{};
         const auto new_path = std::filesystem::absolute(path, err);
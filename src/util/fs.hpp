@@ -2,16 +2,59 @@
 #define FS_HPP_
 
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace fs {
+    /// A read-only memory mapping of a file. The mapping is released on destruction.
+    ///
+    /// If the file is truncated while mapped, accessing the truncated part would raise SIGBUS. The pages are replaced
+    /// with zeroed memory instead and the mapping is marked as truncated.
+    struct MappedFile {
+    private:
+        const char* data_;
+        std::size_t size_;
+        /// Slot of the mapping in the registry consulted on SIGBUS.
+        std::size_t slot_;
+
+    public:
+        MappedFile(const char* data, std::size_t size, std::size_t slot);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        auto operator=(const MappedFile&) -> MappedFile& = delete;
+        MappedFile(MappedFile&&) = delete;
+        auto operator=(MappedFile&&) -> MappedFile& = delete;
+
+        [[nodiscard]]
+        auto view() const -> std::string_view;
+        /// Checks if the file was truncated while mapped. The truncated part of the view reads as zeros.
+        [[nodiscard]]
+        auto truncated() const -> bool;
+    };
+
     /// Reads a file and returns it contents on success.
     [[nodiscard]]
     auto read_file(const std::filesystem::path& path) -> std::optional<std::string>;
+    /// Maps a non-empty file read-only into memory and returns the mapping on success. Files that are likely to be
+    /// truncated meanwhile (open for writing, recently modified, or on network or userspace filesystems) are not
+    /// mapped.
+    [[nodiscard]]
+    auto map_file(const std::filesystem::path& path) -> std::optional<std::shared_ptr<const MappedFile>>;
     /// Writes a string to a file.
     [[nodiscard]]
     auto write_file(const std::filesystem::path& path, std::string_view contents, std::ios_base::openmode mode) -> bool;
+    /// Atomically replaces a file with a sequence of chunks. The chunks are written to a uniquely named temporary file
+    /// next to it, which is synced to disk and renamed over the file, keeping its permissions and (if permitted) owner.
+    /// Symlinks are followed. If keep_links is set, files with multiple hard links are overwritten in place instead to
+    /// keep the links, which must not happen while the file is mapped. Blocks until done, it is meant to be called on a
+    /// worker thread.
+    [[nodiscard]]
+    auto replace_file(const std::filesystem::path& path, const std::vector<std::string_view>& chunks, bool keep_links)
+        -> bool;
 
     /// Converts a path to an absolute path.
     [[nodiscard]]
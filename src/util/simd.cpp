@@ -0,0 +1,103 @@
+#include "simd.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+
+    #define SIMD_X86 1
+#endif
+
+namespace simd {
+    namespace {
+        using find_newlines_fn = void (*)(std::string_view, std::vector<std::size_t>&);
+
+        /// Scalar fallback. memchr is usually vectorized by the C library, making this fast for long lines.
+        void find_newlines_scalar(const std::string_view data, std::vector<std::size_t>& offsets) {
+            for (auto idx = data.find('\n'); idx != std::string_view::npos; idx = data.find('\n', idx + 1)) {
+                offsets.push_back(idx);
+            }
+        }
+
+#if SIMD_X86
+        /// Appends the offsets of all set bits in mask, relative to base.
+        inline void push_mask(std::uint32_t mask, const std::size_t base, std::vector<std::size_t>& offsets) {
+            while (mask != 0) {
+                offsets.push_back(base + std::countr_zero(mask));
+                mask &= mask - 1;
+            }
+        }
+
+        __attribute__((target("sse2"))) void
+        find_newlines_sse2(const std::string_view data, std::vector<std::size_t>& offsets) {
+            const auto nl = _mm_set1_epi8('\n');
+
+            auto idx{0UZ};
+            for (; idx + 16 <= data.size(); idx += 16) {
+                const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data.data() + idx));
+                push_mask(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nl))), idx, offsets);
+            }
+
+            for (; idx < data.size(); idx += 1) {
+                if (data[idx] == '\n') { offsets.push_back(idx); }
+            }
+        }
+
+        __attribute__((target("avx2"))) void
+        find_newlines_avx2(const std::string_view data, std::vector<std::size_t>& offsets) {
+            const auto nl = _mm256_set1_epi8('\n');
+
+            auto idx{0UZ};
+            for (; idx + 64 <= data.size(); idx += 64) {
+                const auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data.data() + idx));
+                const auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data.data() + idx + 32));
+                const auto lo_mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, nl)));
+                const auto hi_mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, nl)));
+
+                // Skip newline-free blocks with a single branch.
+                if ((lo_mask | hi_mask) == 0) { continue; }
+
+                push_mask(lo_mask, idx, offsets);
+                push_mask(hi_mask, idx + 32, offsets);
+            }
+
+            for (; idx + 32 <= data.size(); idx += 32) {
+                const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data.data() + idx));
+                const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, nl)));
+                push_mask(mask, idx, offsets);
+            }
+
+            for (; idx < data.size(); idx += 1) {
+                if (data[idx] == '\n') { offsets.push_back(idx); }
+            }
+        }
+#endif
+
+        struct Scanner {
+        public:
+            find_newlines_fn fn_;
+            std::string_view name_;
+        };
+
+        auto select_scanner() -> Scanner {
+#if SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) { return Scanner{.fn_ = find_newlines_avx2, .name_ = "avx2"}; }
+            if (__builtin_cpu_supports("sse2")) { return Scanner{.fn_ = find_newlines_sse2, .name_ = "sse2"}; }
+#endif
+            return Scanner{.fn_ = find_newlines_scalar, .name_ = "scalar"};
+        }
+
+        auto scanner() -> const Scanner& {
+            static const Scanner scanner = select_scanner();
+            return scanner;
+        }
+    } // namespace
+
+    void find_newlines(const std::string_view data, std::vector<std::size_t>& offsets) {
+        scanner().fn_(data, offsets);
+    }
+
+    auto newline_scanner() -> std::string_view { return scanner().name_; }
+} // namespace simd
@@ -0,0 +1,18 @@
+#ifndef SIMD_HPP_
+#define SIMD_HPP_
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace simd {
+    /// Appends the offsets of all newline characters in data to offsets. The fastest implementation supported by the
+    /// CPU (AVX2, SSE2 or scalar) is selected at runtime.
+    void find_newlines(std::string_view data, std::vector<std::size_t>& offsets);
+
+    /// Returns the name of the implementation selected by simd::find_newlines.
+    [[nodiscard]]
+    auto newline_scanner() -> std::string_view;
+} // namespace simd
+
+#endif
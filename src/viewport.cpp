@@ -1,12 +1,15 @@
 #include "viewport.hpp"
 
+#include <algorithm>
 #include <limits>
 
 #include "container/face_cache.hpp"
+#include "container/face_registry.hpp"
 #include "document.hpp"
 #include "document_view.hpp"
 #include "editor.hpp"
 #include "render/display.hpp"
+#include "types/atom.hpp"
 #include "types/face.hpp"
 #include "util/assert.hpp"
 #include "util/math.hpp"
@@ -57,6 +60,8 @@ void Viewport::change_document_view(const std::shared_ptr<DocumentView>& view) {
     if (is_active && old_doc) { editor->emit_event("document_view::unfocus", this->view_); }
 
     this->view_ = view;
+    this->rendered_row_ = std::nullopt;
+    this->row_segments_key_ = std::nullopt;
     this->view_->reset_cursor();
     this->adjust_viewport();
 
@@ -92,13 +97,14 @@ void Viewport::resize(const std::size_t width, const std::size_t height, const P
     this->width_ = width;
     this->height_ = height;
     this->offset_ = offset;
+    this->rendered_row_ = std::nullopt;
 
     this->adjust_viewport();
 
     Editor::instance()->emit_event("viewport::resized", this->shared_from_this());
 }
 
-auto Viewport::render(Display& display, const sol::protected_function& resolve_face) const -> bool {
+auto Viewport::render(Display& display, FaceRegistry& faces) const -> bool {
     if (this->view_->mode_line_ && !this->view_->mode_line_callback_.valid()) {
         // Triggers a rerender.
         this->view_->mode_line_ = false;
@@ -110,30 +116,30 @@ auto Viewport::render(Display& display, const sol::protected_function& resolve_f
     auto height = this->view_->mode_line_ ? math::sub_sat(this->height_, 1UZ) : this->height_;
     if (height == 0) { return false; }
 
-    Face default_face{};
-    if (const auto f = resolve_face(this->view_, "default"); f.valid()) {
-        default_face = f.get<Face>();
-    } else {
-        ASSERT(false, "default face must be defined");
-    }
-    Face gutter_face{};
-    if (const auto f = resolve_face(this->view_, "gutter"); f.valid()) {
-        gutter_face = f.get<Face>();
-    } else {
-        ASSERT(false, "gutter face must be defined");
-    }
-    Face replacement_face{};
-    if (const auto f = resolve_face(this->view_, "replacement"); f.valid()) {
-        replacement_face = f.get<Face>();
-    } else {
-        ASSERT(false, "replacement face must be defined");
-    }
-    Face current_line_face{};
-    if (const auto f = resolve_face(this->view_, "current_line"); f.valid()) {
-        current_line_face = f.get<Face>();
-    } else {
-        ASSERT(false, "current line face must be defined");
+    // Rows still visible after a vertical scroll are moved on the Display instead of redrawn. Scrolling moves whole
+    // Display rows, so this only pays off for viewports spanning its full width.
+    if (this->rendered_row_ && this->offset_.col_ == 0 && this->width_ == display.width()) {
+        display.scroll(
+            this->offset_.row_, this->offset_.row_ + height,
+            static_cast<std::ptrdiff_t>(this->scroll_.row_) - static_cast<std::ptrdiff_t>(*this->rendered_row_));
     }
+    this->rendered_row_ = this->scroll_.row_;
+
+    auto& lua = Editor::instance()->lua_;
+    const auto resolve_face = [&](const Atom name) -> std::optional<Face> {
+        return faces.resolve(*this->view_, name, lua);
+    };
+
+    // Faces the view cannot be drawn without.
+    const auto required_face = [&](const Atom name) -> Face {
+        const auto face = resolve_face(name);
+        ASSERT(face, "face must be defined");
+        return *face;
+    };
+    const auto default_face = required_face(atoms::DEFAULT_FACE);
+    const auto gutter_face = required_face(atoms::GUTTER_FACE);
+    const auto replacement_face = required_face(atoms::REPLACEMENT);
+    const auto current_line_face = required_face(atoms::CURRENT_LINE_FACE);
 
     auto gutter_width{0UZ};
     if (this->view_->gutter_) {
@@ -150,42 +156,31 @@ auto Viewport::render(Display& display, const sol::protected_function& resolve_f
     const auto nl = static_cast<sol::optional<std::string_view>>(this->view_->properties_["nl"]).value_or(" ");
     const auto tab = static_cast<sol::optional<std::string_view>>(this->view_->properties_["tab"]).value_or(" ");
 
-    Face ws_face{};
-    if (const auto f = resolve_face(this->view_, "ws"); f.valid()) {
-        ws_face = f.get<Face>();
-    } else {
-        ws_face = default_face;
-    }
-    Face nl_face{};
-    if (const auto f = resolve_face(this->view_, "nl"); f.valid()) {
-        nl_face = f.get<Face>();
-    } else {
-        nl_face = default_face;
-    }
-    Face tab_face{};
-    if (const auto f = resolve_face(this->view_, "tab"); f.valid()) {
-        tab_face = f.get<Face>();
-    } else {
-        tab_face = default_face;
-    }
+    const auto ws_face = resolve_face(atoms::WS_FACE).value_or(default_face);
+    const auto nl_face = resolve_face(atoms::NL_FACE).value_or(default_face);
+    const auto tab_face = resolve_face(atoms::TAB_FACE).value_or(default_face);
 
     this->visual_cur_ = std::nullopt;
     const auto cur_byte = this->view_->cur_.point(*this->view_);
 
+    // Skip everything before the first visible row instead of walking the Document from the beginning.
+    const auto anchor = this->find_row_anchor(this->scroll_.row_);
+
     std::vector<FaceCache> doc_caches;
     std::vector<FaceCache> view_caches;
     doc_caches.reserve(Editor::instance()->face_layers_.size());
     view_caches.reserve(Editor::instance()->face_layers_.size());
     for (const auto& layer: Editor::instance()->face_layers_) {
-        doc_caches.emplace_back(0, layer, this->view_->doc_->text_properties_);
-        view_caches.emplace_back(0, layer, this->view_->view_properties_);
+        const Atom key{layer};
+        doc_caches.emplace_back(key, this->view_->doc_->text_properties_);
+        view_caches.emplace_back(key, this->view_->view_properties_);
     }
 
-    auto logical_y{1UZ};
+    auto logical_y = anchor.line_ + 1;
     auto last_rendered_gutter_y{0UZ};
     auto x{0UZ};
-    auto y{0UZ};
-    auto idx{0UZ};
+    auto y = anchor.row_;
+    auto idx = anchor.byte_;
 
     auto fill_line = [&] -> void {
         if (y >= this->scroll_.row_) {
@@ -208,13 +203,11 @@ auto Viewport::render(Display& display, const sol::protected_function& resolve_f
             if (logical_y - 1 == this->view_->cur_.pos_.row_) { face.merge(current_line_face); }
 
             for (auto& cache: doc_caches) {
-                cache.update(
-                    idx, [&](const auto name) -> sol::optional<Face> { return resolve_face(this->view_, name); });
+                cache.update(idx, resolve_face);
                 if (cache.face_) { face.merge(*cache.face_); }
             }
             for (auto& cache: view_caches) {
-                cache.update(
-                    idx, [&](const auto name) -> sol::optional<Face> { return resolve_face(this->view_, name); });
+                cache.update(idx, resolve_face);
                 if (cache.face_) { face.merge(*cache.face_); }
             }
             if (replacement && cur_byte == idx) { face.merge(replacement_face); }
@@ -253,6 +246,8 @@ auto Viewport::render(Display& display, const sol::protected_function& resolve_f
         }
     };
 
+    // Backs characters spanning multiple pieces.
+    std::string ch_buffer{};
     while (y < this->scroll_.row_ + height && idx < this->view_->doc_->size()) {
         if (cur_byte == idx) { this->visual_cur_ = {.row_ = y, .col_ = x}; }
 
@@ -265,8 +260,8 @@ auto Viewport::render(Display& display, const sol::protected_function& resolve_f
             last_rendered_gutter_y = logical_y;
         }
 
-        if (const auto* const replacement = this->view_->get_raw_view_property(idx, "replacement"); replacement) {
-            const auto contents = replacement->value_.as<std::string_view>();
+        if (const auto* const replacement = this->view_->get_raw_view_property(idx, atoms::REPLACEMENT); replacement) {
+            const auto contents = replacement->value_.string().value_or("");
 
             auto jdx{0UZ};
             while (y < this->scroll_.row_ + height && jdx < contents.size()) {
@@ -278,11 +273,14 @@ auto Viewport::render(Display& display, const sol::protected_function& resolve_f
             }
 
             idx += replacement->end_ - replacement->start_;
-            logical_y += std::ranges::count(this->view_->doc_->slice(replacement->start_, replacement->end_), '\n');
+            this->view_->doc_->for_each_chunk(
+                replacement->start_, replacement->end_,
+                [&](const std::string_view chunk) -> void { logical_y += std::ranges::count(chunk, '\n'); });
         } else {
-            const auto ch_len = utf8::len(this->view_->doc_->slice(idx, idx + 1)[0]);
-            const auto ch =
-                idx + ch_len <= this->view_->doc_->size() ? this->view_->doc_->slice(idx, idx + ch_len) : "";
+            const auto ch_len = utf8::len(this->view_->doc_->at(idx));
+            const auto ch = idx + ch_len <= this->view_->doc_->size()
+                                ? this->view_->doc_->slice(idx, idx + ch_len, ch_buffer)
+                                : std::string_view{};
 
             if (x < this->scroll_.col_ + content_width || ch == "\n") { draw(ch, false); }
 
@@ -314,11 +312,11 @@ auto Viewport::render(Display& display, const sol::protected_function& resolve_f
         y += 1;
     }
 
-    if (this->view_->mode_line_) { return this->render_mode_line(display, resolve_face); }
+    if (this->view_->mode_line_) { return this->render_mode_line(display, faces); }
     return true;
 }
 
-auto Viewport::render_mode_line(Display& display, const sol::protected_function& resolve_face) const -> bool {
+auto Viewport::render_mode_line(Display& display, FaceRegistry& faces) const -> bool {
     const auto res = this->view_->mode_line_callback_(this);
     if (!res.valid() || res.get_type() != sol::type::table) {
         sol::error err{"Expected a Mode Line table."};
@@ -331,12 +329,10 @@ auto Viewport::render_mode_line(Display& display, const sol::protected_function&
         return false;
     }
 
-    Face mode_line_face{};
-    if (const auto f = resolve_face(this->view_, "mode_line"); f.valid()) {
-        mode_line_face = f.get<Face>();
-    } else {
-        ASSERT(false, "mode_line face must be defined");
-    }
+    auto& lua = Editor::instance()->lua_;
+    const auto mode_line_face = faces.resolve(*this->view_, atoms::MODE_LINE_FACE, lua);
+    ASSERT(mode_line_face, "mode_line face must be defined");
+
     auto tab_width{4UZ};
     if (const sol::optional<std::size_t> t = this->view_->properties_["tab_width"]; t) { tab_width = *t; }
 
@@ -364,13 +360,13 @@ auto Viewport::render_mode_line(Display& display, const sol::protected_function&
     }
 
     auto get_face = [&](const sol::table& segment) -> Face {
-        auto face = mode_line_face;
-        sol::optional<Face> resolved{};
+        auto face = *mode_line_face;
+        std::optional<Face> resolved{};
 
         if (segment["face"].is<Face>()) {
             resolved = segment["face"].get<Face>();
         } else if (segment["face"].get_type() == sol::type::string) {
-            resolved = resolve_face(this->view_, segment["face"].get<std::string_view>());
+            resolved = faces.resolve(*this->view_, Atom{segment["face"].get<std::string_view>()}, lua);
         }
 
         if (resolved) { face.merge(*resolved); }
@@ -416,7 +412,7 @@ auto Viewport::render_mode_line(Display& display, const sol::protected_function&
     // Fill remainder of line.
     if (curr < this->width_) {
         while (curr < this->width_) {
-            this->_draw_char(display, mode_line_face, 0, this->width_, " ", 1, false, curr + this->scroll_.col_, y);
+            this->_draw_char(display, *mode_line_face, 0, this->width_, " ", 1, false, curr + this->scroll_.col_, y);
             curr += 1;
         }
     }
@@ -509,8 +505,11 @@ void Viewport::adjust_viewport() {
     if (this->view_->cur_.pos_.row_ >= this->view_->doc_->line_count()) { return; }
 
     // 2. Horizontal scrolling.
-    const auto line = this->view_->doc_->line(this->view_->cur_.pos_.row_);
-    const auto x = utf8::str_width(line.substr(0, std::min(this->view_->cur_.pos_.col_, line.size())), 0, tab_width);
+    const auto row = this->view_->cur_.pos_.row_;
+    const auto begin = this->view_->doc_->line_begin_byte(row);
+    const auto end = std::min(begin + this->view_->cur_.pos_.col_, this->view_->doc_->line_end_byte(row));
+    std::string buffer{};
+    const auto x = utf8::str_width(this->view_->doc_->slice(begin, end, buffer), 0, tab_width);
 
     auto gutter{0UZ};
     if (this->view_->gutter_) { gutter = (total_lines > 0 ? static_cast<size_t>(std::log10(total_lines)) + 1 : 1) + 2; }
@@ -522,6 +521,121 @@ void Viewport::adjust_viewport() {
     }
 }
 
+auto Viewport::find_row_anchor(const std::size_t row) const -> RowAnchor {
+    this->update_row_segments();
+
+    const auto& doc = *this->view_->doc_;
+    const auto first_line = [&](const RowSegment& segment) -> std::ptrdiff_t {
+        const auto line = doc.position_from_byte(segment.first_byte_).row_;
+        return static_cast<std::ptrdiff_t>(segment.next_line_ ? line + 1 : line);
+    };
+    const auto last_line = [&](const RowSegment& segment) -> std::ptrdiff_t {
+        return static_cast<std::ptrdiff_t>(
+            segment.last_byte_ ? doc.position_from_byte(*segment.last_byte_).row_ : doc.line_count() - 1);
+    };
+
+    // The visual rows of the segment starts never decrease, find the last segment starting at or before the row.
+    auto it = std::ranges::partition_point(this->row_segments_, [&](const RowSegment& segment) -> bool {
+        return first_line(segment) + segment.delta_ <= static_cast<std::ptrdiff_t>(row);
+    });
+
+    // Skip segments without lines, e.g. between two replacements on the same line.
+    while (it != this->row_segments_.begin()) {
+        it = std::prev(it);
+
+        const auto first = first_line(*it);
+        const auto last = last_line(*it);
+        if (first > last) { continue; }
+
+        const auto line = static_cast<std::size_t>(std::min(last, static_cast<std::ptrdiff_t>(row) - it->delta_));
+        return RowAnchor{
+            .byte_ = doc.line_begin_byte(line),
+            .line_ = line,
+            .row_ = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(line) + it->delta_)};
+    }
+
+    return RowAnchor{.byte_ = 0, .line_ = 0, .row_ = 0};
+}
+
+void Viewport::update_row_segments() const {
+    const auto& doc = *this->view_->doc_;
+
+    if (this->row_segments_key_ &&
+        this->row_segments_key_->replacements_revision_ == this->view_->replacements_revision_) {
+        if (this->row_segments_key_->doc_revision_ == doc.revision()) { return; }
+
+        if (const auto changes = doc.changes_since(this->row_segments_key_->doc_revision_);
+            changes && this->shift_row_segments(*changes)) {
+            this->row_segments_key_->doc_revision_ = doc.revision();
+            return;
+        }
+    }
+
+    this->row_segments_.clear();
+    this->row_replacements_.clear();
+    this->row_segments_key_ = RowSegmentsKey{
+        .doc_revision_ = doc.revision(), .replacements_revision_ = this->view_->replacements_revision_};
+
+    // Visual rows only diverge from lines at replacements spanning or containing newlines. Between two of those, the
+    // visual row of a line start is the line shifted by the accumulated difference of newlines.
+    RowSegment segment{.first_byte_ = 0, .next_line_ = false, .last_byte_ = std::nullopt, .delta_ = 0};
+
+    if (const auto it = this->view_->view_properties_.properties_.find(atoms::REPLACEMENT);
+        it != this->view_->view_properties_.properties_.end()) {
+        it->second.for_each([&](const Property& replacement) -> bool {
+            this->row_replacements_.emplace_back(replacement.start_, replacement.end_);
+
+            const auto start = doc.position_from_byte(replacement.start_);
+            const auto end = doc.position_from_byte(replacement.end_);
+
+            const auto contents = replacement.value_.string().value_or("");
+            const auto contents_lines = std::ranges::count(contents, '\n');
+            const auto doc_lines = static_cast<std::ptrdiff_t>(end.row_ - start.row_);
+            if (contents_lines == 0 && doc_lines == 0) { return true; }
+
+            segment.last_byte_ = replacement.start_;
+            this->row_segments_.push_back(segment);
+
+            // The line the replacement ends in only starts a visual row if the contents end the row before it.
+            segment = RowSegment{
+                .first_byte_ = replacement.end_,
+                .next_line_ = end.col_ != 0 || !contents.ends_with('\n'),
+                .last_byte_ = std::nullopt,
+                .delta_ = segment.delta_ + contents_lines - doc_lines};
+
+            return true;
+        });
+    }
+
+    this->row_segments_.push_back(segment);
+}
+
+auto Viewport::shift_row_segments(const std::vector<Change>& changes) const -> bool {
+    for (const auto& change: changes) {
+        const auto end = change.pos_ + change.removed_;
+        const auto shift = [&](std::size_t& byte) -> void {
+            if (byte >= end) { byte = byte - change.removed_ + change.inserted_; }
+        };
+
+        // Replacements are sorted and disjoint, only the first one ending at or behind the Change may touch it.
+        auto it = std::ranges::lower_bound(
+            this->row_replacements_, change.pos_, {},
+            [](const std::pair<std::size_t, std::size_t>& range) -> std::size_t { return range.second; });
+        if (it != this->row_replacements_.end() && it->first <= end) { return false; }
+
+        for (; it != this->row_replacements_.end(); ++it) {
+            shift(it->first);
+            shift(it->second);
+        }
+        for (auto& segment: this->row_segments_) {
+            shift(segment.first_byte_);
+            if (segment.last_byte_) { shift(*segment.last_byte_); }
+        }
+    }
+
+    return true;
+}
+
 void Viewport::_draw_gutter(
     Display& display, const Face face, const std::size_t gutter_width, const std::optional<std::size_t> line,
     const std::size_t y) const {
@@ -579,7 +693,7 @@ void Viewport::_draw_char(
         if (n == 0) {
             display.update(this->offset_.col_ + gutter_width + vx, this->offset_.row_ + vy, cell);
         } else { // Expand tab or wide characters.
-            Cell filler("", cell.fg_, cell.bg_);
+            Cell filler("", cell.fg(), cell.bg());
             if (tab) {
                 filler.set_char(' ');
             } else if (x < this->scroll_.col_) { // Half-cutoff wide character.
@@ -1,15 +1,20 @@
 #ifndef VIEW_HPP_
 #define VIEW_HPP_
 
+#include <optional>
+#include <vector>
+
 #include <sol/protected_function.hpp>
 
 #include "types/position.hpp"
 #include "util/ansi.hpp"
 #include "util/instance_tracker.hpp"
 
+struct Change;
 struct Display;
 struct DocumentView;
 struct Face;
+struct FaceRegistry;
 struct MiniBuffer;
 struct ViewportBinding;
 
@@ -22,6 +27,40 @@ struct Viewport : public InstanceTracker<Viewport>, public std::enable_shared_fr
     friend MiniBuffer;
     friend ViewportBinding;
 
+private:
+    /// The start of a visual row in the Document.
+    struct RowAnchor {
+    public:
+        /// Byte the visual row starts at.
+        std::size_t byte_;
+        /// Line containing the byte.
+        std::size_t line_;
+        /// Visual row.
+        std::size_t row_;
+    };
+
+    /// Consecutive lines whose visual rows are only shifted against their line numbers. The bounds are bytes, so they
+    /// can be shifted by edits without resolving lines.
+    struct RowSegment {
+    public:
+        /// Byte the first line starts at or, if next_line_ is set, the byte in the line before the first line.
+        std::size_t first_byte_;
+        bool next_line_;
+        /// Byte in the last line, nothing if the segment extends to the end of the Document.
+        std::optional<std::size_t> last_byte_;
+        /// Difference of the visual rows to the lines.
+        std::ptrdiff_t delta_;
+    };
+
+    /// Document and replacement revisions the row segments were built for.
+    struct RowSegmentsKey {
+    public:
+        std::size_t doc_revision_;
+        std::size_t replacements_revision_;
+
+        auto operator==(const RowSegmentsKey&) const -> bool = default;
+    };
+
 public:
     std::shared_ptr<DocumentView> view_;
 
@@ -36,6 +75,14 @@ private:
 
     /// Visual cursor position.
     mutable std::optional<Position> visual_cur_{};
+    /// First visible row of the last render, to replay vertical scrolls on the Display.
+    mutable std::optional<std::size_t> rendered_row_{};
+    /// Segments of lines between replacements spanning or containing newlines, ordered by their visual rows.
+    mutable std::vector<RowSegment> row_segments_{};
+    /// Ranges of all replacements the row segments were built from. Edits touching them require a rebuild.
+    mutable std::vector<std::pair<std::size_t, std::size_t>> row_replacements_{};
+    /// Revisions row_segments_ are valid for, nothing if they need to be rebuilt.
+    mutable std::optional<RowSegmentsKey> row_segments_key_{};
 
 public:
     Viewport(std::size_t width, std::size_t height, std::shared_ptr<DocumentView> view);
@@ -59,14 +106,25 @@ public:
     void resize(std::size_t width, std::size_t height, Position offset);
     /// Renders the viewport to the Display, returning if the rendering was successful.
     [[nodiscard]]
-    auto render(Display& display, const sol::protected_function& resolve_face) const -> bool;
+    auto render(Display& display, FaceRegistry& faces) const -> bool;
     /// Renders the mode line, returning if the rendering was successful.
     [[nodiscard]]
-    auto render_mode_line(Display& display, const sol::protected_function& resolve_face) const -> bool;
+    auto render_mode_line(Display& display, FaceRegistry& faces) const -> bool;
     /// Renders the viewport's cursor to the Display.
     void render_cursor(Display& display, ansi::CursorStyle style) const;
 
 private:
+    /// Finds the last line start at or before the visual row, accounting for replacements spanning or containing
+    /// newlines.
+    [[nodiscard]]
+    auto find_row_anchor(std::size_t row) const -> RowAnchor;
+    /// Updates the row segments to the current Document and replacements. Edits are shifted into them, they are only
+    /// rebuilt if the replacements changed or an edit touched one.
+    void update_row_segments() const;
+    /// Shifts the row segments by the Changes, returning false if a Change touched a replacement.
+    [[nodiscard]]
+    auto shift_row_segments(const std::vector<Change>& changes) const -> bool;
+
     void _draw_gutter(
         Display& display, Face face, std::size_t gutter_width, std::optional<std::size_t> line, std::size_t y) const;
     void _draw_char(